@@ -0,0 +1,51 @@
+#include "Animation.h"
+
+void startAnimation(Animator &animator, const AnimationDef *def)
+{
+    memcpy_P(&animator.def, def, sizeof(AnimationDef));
+    animator.frame = 0;
+    animator.tick = 0;
+    animator.dir = 1;
+    // a single frame has nothing to step through, and PingPong would run off the end of it
+    animator.active = animator.def.frames > 1;
+}
+
+void stopAnimation(Animator &animator)
+{
+    animator.active = false;
+}
+
+void tickAnimators(Animator *animators, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        Animator &a = animators[i];
+        if (!a.active)
+            continue;
+
+        if (++a.tick < a.def.ticks_per_frame)
+            continue;
+        a.tick = 0;
+
+        uint8_t last = a.def.frames - 1;
+        switch (a.def.mode)
+        {
+        case AnimMode::Loop:
+            a.frame = (a.frame < last) ? a.frame + 1 : 0;
+            break;
+        case AnimMode::PingPong:
+            a.frame += a.dir;
+            if (a.frame >= last)
+                a.dir = -1;
+            else if (a.frame == 0)
+                a.dir = 1;
+            break;
+        case AnimMode::Once:
+            if (a.frame < last)
+                a.frame++;
+            else
+                a.active = false;
+            break;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduboy2.h>
+
+enum class AnimMode : uint8_t
+{
+    Loop,     // 0, 1, .. last, 0, 1, ..
+    PingPong, // 0, 1, .. last, .. 1, 0, 1, ..
+    Once,     // 0, 1, .. last, then stops
+};
+
+// describes an animation, kept in PROGMEM
+struct AnimationDef {
+    uint8_t frames;
+    AnimMode mode;
+    uint8_t ticks_per_frame;
+};
+
+// a running animation. the def is copied out of PROGMEM when it starts
+struct Animator {
+    AnimationDef def;
+    uint8_t frame;
+    uint8_t tick;
+    int8_t dir;
+    bool active;
+};
+
+void startAnimation(Animator &animator, const AnimationDef *def);
+void stopAnimation(Animator &animator);
+
+// advances every active animator by one game tick
+void tickAnimators(Animator *animators, uint8_t count);
@@ -0,0 +1,156 @@
+#include "Audio.h"
+#include "SoundFx.h"
+
+#if AUDIO_BACKEND == AUDIO_BEEP
+
+// BeepPin1 counts are for a 1MHz toggle clock
+uint16_t beepCount(unsigned int frequency)
+{
+    if (frequency < 16)
+        frequency = 16;
+
+    return ((1000000UL + (frequency / 2)) / frequency) - 1;
+}
+
+BeepAudio::BeepAudio(bool (*outEn)())
+{
+    _out_enabled = outEn;
+    _score = nullptr;
+    _tone_playing = false;
+}
+
+void BeepAudio::begin()
+{
+    BeepPin1::begin();
+}
+
+void BeepAudio::update()
+{
+    unsigned long now = millis();
+
+    if (_tone_playing && (long)(now - _tone_end_ms) >= 0)
+    {
+        _tone_playing = false;
+        BeepPin1::noTone();
+    }
+
+    // step through every score command that is due. there is only one voice,
+    // so the channel number of note on/off commands is ignored
+    while (_score != nullptr && (long)(now - _next_event_ms) >= 0)
+    {
+        byte cmd = pgm_read_byte(_score++);
+
+        if (cmd < 0x80)
+        {
+            // 15 bit wait in ms
+            _next_event_ms += ((uint16_t)cmd << 8) | pgm_read_byte(_score++);
+        }
+        else if ((cmd & 0xF0) == 0x90)
+        {
+            BeepPin1::tone(beepCount(noteFrequency(pgm_read_byte(_score++))));
+        }
+        else if ((cmd & 0xF0) == 0x80)
+        {
+            BeepPin1::noTone();
+        }
+        else
+        {
+            // end of score (restarting isn't supported)
+            stopScore();
+        }
+    }
+}
+
+void BeepAudio::playScore(const byte *score)
+{
+    if (!_out_enabled())
+        return;
+
+    _tone_playing = false;
+    _score = score;
+    _next_event_ms = millis();
+    update();
+}
+
+void BeepAudio::stopScore()
+{
+    _score = nullptr;
+    BeepPin1::noTone();
+}
+
+bool BeepAudio::playing()
+{
+    return _score != nullptr || _tone_playing;
+}
+
+void BeepAudio::tone(unsigned int frequency, unsigned long duration)
+{
+    if (!_out_enabled())
+        return;
+
+    // a tone takes over the only voice
+    _score = nullptr;
+    BeepPin1::tone(beepCount(frequency));
+    _tone_end_ms = millis() + duration;
+    _tone_playing = true;
+}
+
+void BeepAudio::stopTone()
+{
+    if (!_tone_playing)
+        return;
+
+    _tone_playing = false;
+    BeepPin1::noTone();
+}
+
+#else
+
+PlaytuneAudio::PlaytuneAudio(bool (*outEn)())
+    : ArduboyPlaytune(outEn)
+{
+}
+
+void PlaytuneAudio::begin()
+{
+    initChannel(PIN_SPEAKER_1);
+    initChannel(PIN_SPEAKER_2);
+}
+
+// ArduboyPlaytune has no way to cut a tone short, and a duration of 0 plays forever.
+// a 1ms tone takes its place and ends in the interrupt the usual way, which also
+// gives the score back the channel the tone had
+void PlaytuneAudio::stopTone()
+{
+    tone(1000, 1);
+}
+
+#endif
+
+uint32_t countBusyLoops(uint16_t window_ms)
+{
+    volatile uint32_t loops = 0;
+    unsigned long start = millis();
+    while (millis() - start < window_ms)
+        loops++;
+
+    return loops;
+}
+
+// compares how far a busy loop gets in a fixed time with and without a tone playing.
+// whatever the loop lost while the tone played was spent in audio interrupts
+uint32_t measureIsrCycles(AudioOut *audio)
+{
+    const uint16_t window_ms = 100;
+
+    uint32_t silent_loops = countBusyLoops(window_ms);
+    audio->tone(noteFrequency(85), window_ms * 2);
+    uint32_t playing_loops = countBusyLoops(window_ms);
+    audio->update();
+
+    if (playing_loops >= silent_loops)
+        return 0;
+
+    uint32_t lost_per_mille = ((silent_loops - playing_loops) * 1000) / silent_loops;
+    return lost_per_mille * (F_CPU / 1000);
+}
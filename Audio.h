@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+
+// every backend has the same interface, so call sites don't care which one is built:
+//   begin()      - set up the output pins/timers, call once in setup()
+//   update()     - advance scores and tone durations, call once per frame
+//   playScore()  - play a Playtune score from PROGMEM
+//   stopScore()
+//   playing()    - true while a score is playing
+//   tone()       - play a single tone (Hz) for a duration (ms)
+//   stopTone()   - silence a tone before its duration is up
+
+#if AUDIO_BACKEND == AUDIO_BEEP
+
+class BeepAudio {
+    public:
+        BeepAudio(bool (*outEn)());
+        void begin();
+        void update();
+        void playScore(const byte *score);
+        void stopScore();
+        bool playing();
+        void tone(unsigned int frequency, unsigned long duration);
+        void stopTone();
+
+    private:
+        bool (*_out_enabled)();
+        const byte *_score;
+        unsigned long _next_event_ms;
+        unsigned long _tone_end_ms;
+        bool _tone_playing;
+};
+
+typedef BeepAudio AudioOut;
+
+#else
+
+#include <ArduboyPlaytune.h>
+
+class PlaytuneAudio : public ArduboyPlaytune {
+    public:
+        PlaytuneAudio(bool (*outEn)());
+        void begin();
+        void update() {}
+        void stopTone();
+};
+
+typedef PlaytuneAudio AudioOut;
+
+#endif
+
+uint32_t measureIsrCycles(AudioOut *audio);
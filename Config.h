@@ -0,0 +1,108 @@
+#pragma once
+
+// compile time options. each one can also be overridden with a -D build flag
+
+// when 1, FrameScheduler picks the frame rate from the game state and cpu load
+// (60 fps in game when there's headroom, 15 fps on the help and game over screens).
+// when 0 the game always runs at FRAME_RATE. gameplay speed is the same either way
+#ifndef ADAPTIVE_FRAME_RATE
+#define ADAPTIVE_FRAME_RATE 1
+#endif
+
+#ifndef FRAME_RATE
+#define FRAME_RATE 30
+#endif
+
+// when 1, skip the scrolling ARDUBOY logo at power on and go straight to the start menu
+#ifndef SKIP_BOOT_LOGO
+#define SKIP_BOOT_LOGO 0
+#endif
+
+// 0 seeds random() from ADC noise at boot. any other value is used as a fixed seed,
+// so a run with the same button presses draws the same frames (see the profiler's frame hash)
+#ifndef RANDOM_SEED
+#define RANDOM_SEED 0
+#endif
+
+// how many squirrels and balls can be on screen at once, and how many grass
+// tufts scroll by. every entity slot costs RAM, check tools/ram_report.py after raising these
+#ifndef MAX_SQUIRRELS
+#define MAX_SQUIRRELS 10
+#endif
+
+#ifndef MAX_BALLS
+#define MAX_BALLS 10
+#endif
+
+#ifndef NUM_GRASS
+#define NUM_GRASS 6
+#endif
+
+// particles from barked squirrels and collected balls. when a burst needs more
+// than are free, the oldest particles are reused. updating and drawing always
+// walks the whole pool, so the cost per frame stays the same however many bursts there are
+#ifndef MAX_PARTICLES
+#define MAX_PARTICLES 16
+#endif
+
+// audio backends:
+//   AUDIO_PLAYTUNE - ArduboyPlaytune, 2 channels driven by timer interrupts
+//   AUDIO_BEEP     - Arduboy2's BeepPin1, 1 channel toggled by the timer hardware, no interrupts
+#define AUDIO_PLAYTUNE 0
+#define AUDIO_BEEP 1
+
+#ifndef AUDIO_BACKEND
+#define AUDIO_BACKEND AUDIO_PLAYTUNE
+#endif
+
+// when 1, measure the interrupt cycles per second the audio backend uses
+// while playing a tone and show the result at boot
+#ifndef AUDIO_MEASURE_ISR
+#define AUDIO_MEASURE_ISR 0
+#endif
+
+// when 1, time update/draw/display every frame, paint the stack at startup, and allow
+// an overlay in the status bar. pressing UP and DOWN together cycles it through
+// off, cpu load, stack headroom, time asleep on the current screen and the time
+// from reset to the first interactive frame.
+// when 0 all of it compiles to nothing
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+// when 1, a compact binary record of every frame (update and draw time, entity counts,
+// spawns, barks, score) and the score at each death is sent over USB serial.
+// decode it with tools/stream_decode.py. when 0 it compiles to nothing
+#ifndef TELEMETRY_ENABLED
+#define TELEMETRY_ENABLED 0
+#endif
+
+// most bytes of telemetry written per frame. records that don't fit are dropped,
+// never waited for, so a slow or missing host can't stall the game
+#ifndef TELEMETRY_BYTES_PER_FRAME
+#define TELEMETRY_BYTES_PER_FRAME 24
+#endif
+
+// when 1, the screen is sent over USB serial after every frame, for recording
+// gameplay. only changed pages go out, compressed. tools/stream_decode.py frames
+// turns a capture into images. when 0 it compiles to nothing
+#ifndef FRAME_STREAM_ENABLED
+#define FRAME_STREAM_ENABLED 0
+#endif
+
+// most bytes of screen data written per frame. pages that don't fit finish in later frames
+#ifndef FRAME_STREAM_BYTES_PER_FRAME
+#define FRAME_STREAM_BYTES_PER_FRAME 192
+#endif
+
+// seconds without input on the start menu, help or game over screens before
+// the display is turned off and the cpu powered down. any button turns them back on
+#ifndef DEEP_SLEEP_SECONDS
+#define DEEP_SLEEP_SECONDS 60
+#endif
+
+// the host tests in tests/host count the work of the update loops with this, one unit
+// per entity, particle or spawn slot. on the Arduboy it compiles to nothing
+#ifndef COUNT_WORK
+#define COUNT_WORK(units)
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+// fixed point numbers with 6 fractional bits in an int16_t (10.6, 1 pixel = FIXED_ONE).
+// that covers -512 to 511 pixels, enough for everything between -16 and 256,
+// and keeps every move and compare a 16 bit operation on the AVR
+typedef int16_t fixed10_6;
+
+#define FIXED_SHIFT 6
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+// speeds are in pixels per 33ms game tick (one frame at 30 fps). sim_step is the length
+// of the current frame in ticks, 8.8 fixed point, so the game runs at the same speed
+// at any frame rate. set by Game::setFrameRate()
+extern uint16_t sim_step;
+
+#define TICK_ONE 256 // sim_step of a frame exactly one tick long
+
+inline fixed10_6 pixelToFixed(int16_t pixel)
+{
+    return pixel * FIXED_ONE;
+}
+
+inline int16_t fixedToPixel(fixed10_6 pos)
+{
+    return pos >> FIXED_SHIFT;
+}
+
+// how far something moving at speed travels in one frame. the product needs more
+// than 16 bits at low frame rates, the result doesn't
+inline fixed10_6 frameStep(fixed10_6 speed)
+{
+    return ((int32_t)speed * sim_step) >> 8;
+}
@@ -0,0 +1,55 @@
+#include "FrameScheduler.h"
+
+#define IDLE_FPS 15
+#define BASE_FPS 30
+#define FAST_FPS 60
+
+// load is a percent of the frame. 45% at 30 fps is about 90% at 60,
+// so the two thresholds don't make the rate bounce back and forth
+#define SPEED_UP_LOAD 45
+#define SLOW_DOWN_LOAD 90
+#define SPEED_UP_FRAMES 30 // a second of headroom before going faster
+#define SLOW_DOWN_FRAMES 4 // a few overloaded frames before going slower
+
+FrameScheduler::FrameScheduler()
+{
+    _fps = BASE_FPS;
+    _load_frames = 0;
+}
+
+uint8_t FrameScheduler::update(GameState state, uint8_t cpu_load)
+{
+    if (state == GameState::InHelp || state == GameState::GameOver)
+    {
+        _load_frames = 0;
+        return _fps = IDLE_FPS;
+    }
+
+    if (state != GameState::InGame)
+    {
+        _load_frames = 0;
+        return _fps = BASE_FPS;
+    }
+
+    if (_fps != FAST_FPS)
+    {
+        _fps = BASE_FPS;
+        _load_frames = (cpu_load < SPEED_UP_LOAD) ? _load_frames + 1 : 0;
+        if (_load_frames >= SPEED_UP_FRAMES)
+        {
+            _fps = FAST_FPS;
+            _load_frames = 0;
+        }
+    }
+    else
+    {
+        _load_frames = (cpu_load > SLOW_DOWN_LOAD) ? _load_frames + 1 : 0;
+        if (_load_frames >= SLOW_DOWN_FRAMES)
+        {
+            _fps = BASE_FPS;
+            _load_frames = 0;
+        }
+    }
+
+    return _fps;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Game.h"
+
+// picks the frame rate for the next frames from the game state and the measured cpu load.
+// gameplay runs at 60 fps while there's headroom and falls back to 30 when there isn't,
+// the start menu runs at 30 and the help and game over screens at 15
+class FrameScheduler {
+    public:
+        FrameScheduler();
+        uint8_t update(GameState state, uint8_t cpu_load);
+
+    private:
+        uint8_t _fps;
+        uint8_t _load_frames; // consecutive frames the load has been past the switching point
+};
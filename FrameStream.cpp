@@ -0,0 +1,163 @@
+#include "FrameStream.h"
+
+#if FRAME_STREAM_ENABLED
+
+#define FRAME_END_LENGTH 2
+#define FRAME_COMPLETE 0x01 // every page on the host matches this frame
+#define FRAME_KEY 0x02      // the game state changed, every page is being resent
+#define MIN_RUN 3           // shorter repeats are cheaper as literals
+
+FrameStream::FrameStream(Arduboy2 *arduboy)
+{
+    _arduboy = arduboy;
+    _stale = 0xFF;
+    _page = 0;
+    _col = 0;
+    _torn = false;
+    _seq = 0;
+    _last_state = GameState::StartMenu;
+}
+
+// FNV-1a. fletcher sums were cheaper, but they're linear: a score digit changing to
+// another one often left the page's sums as they were, and the page was never resent
+uint32_t FrameStream::pageHash(uint8_t page)
+{
+    const uint8_t *bytes = _arduboy->getBuffer() + page * WIDTH;
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t i = 0; i < WIDTH; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+// PackBits from column col until the page ends or out is full. a control byte below
+// 128 is followed by that many plus one literal bytes, from 128 up it means the next
+// byte repeats (control - 126) times. col is left at the first column not encoded
+uint8_t FrameStream::encode(const uint8_t *page, uint8_t &col, uint8_t *out, uint8_t max_out)
+{
+    uint8_t length = 0;
+
+    while (col < WIDTH && length + 2 <= max_out)
+    {
+        uint8_t run = 1;
+        while (col + run < WIDTH && run < 129 && page[col + run] == page[col])
+            run++;
+
+        if (run >= MIN_RUN)
+        {
+            out[length++] = 128 + run - 2;
+            out[length++] = page[col];
+            col += run;
+            continue;
+        }
+
+        // literals up to the next run worth encoding, the end of the page or the end of out
+        uint8_t start = col;
+        uint8_t count = 0;
+        while (col < WIDTH && count < 128 && length + 1 + count < max_out)
+        {
+            if (col + MIN_RUN <= WIDTH && page[col] == page[col + 1] && page[col] == page[col + 2])
+                break;
+            col++;
+            count++;
+        }
+
+        out[length++] = count - 1;
+        memcpy(&out[length], &page[start], count);
+        length += count;
+    }
+
+    return length;
+}
+
+// call once per frame, while the buffer still holds what was drawn
+void FrameStream::send(GameState state)
+{
+    uint8_t budget = FRAME_STREAM_BYTES_PER_FRAME;
+    uint8_t flags = 0;
+
+    if (state != _last_state)
+    {
+        _stale = 0xFF;
+        flags |= FRAME_KEY;
+    }
+    _last_state = state;
+
+    uint32_t hashes[SCREEN_PAGES];
+    uint8_t dirty = _stale;
+    for (uint8_t i = 0; i < SCREEN_PAGES; i++)
+    {
+        hashes[i] = pageHash(i);
+        if (hashes[i] != _sent_hash[i])
+            dirty |= 1 << i;
+    }
+
+    // keep room for the frame end, so the host can tell frames apart
+    uint8_t page_budget = budget > 3 + FRAME_END_LENGTH ? budget - 3 - FRAME_END_LENGTH : 0;
+    uint8_t payload[MAX_RECORD];
+
+    for (uint8_t checked = 0; checked < SCREEN_PAGES; )
+    {
+        uint8_t bit = 1 << _page;
+        if (_col == 0 && !(dirty & bit))
+        {
+            _page = (_page + 1) % SCREEN_PAGES;
+            checked++;
+            continue;
+        }
+
+        if (_col == 0)
+        {
+            _sending_hash = hashes[_page];
+            _torn = false;
+        }
+        else if (hashes[_page] != _sending_hash)
+        {
+            _torn = true;
+        }
+
+        // page and column, then at least one control byte and one data byte
+        uint8_t space = recordSpace(page_budget);
+        if (space < 4)
+            break;
+
+        payload[0] = _page;
+        payload[1] = _col;
+        uint8_t length = 2 + encode(_arduboy->getBuffer() + _page * WIDTH, _col, &payload[2], space - 2);
+        sendRecord(RecordType::Page, payload, length, page_budget);
+
+        if (_col < WIDTH)
+            continue;
+
+        // a page that changed while it went out goes again, even if it has changed back to
+        // the hash it started with by then
+        if (_torn)
+        {
+            _stale |= bit;
+            dirty |= bit;
+        }
+        else
+        {
+            _sent_hash[_page] = _sending_hash;
+            _stale &= ~bit;
+            dirty &= ~bit;
+        }
+        _col = 0;
+        _page = (_page + 1) % SCREEN_PAGES;
+        checked++;
+    }
+
+    if (dirty == 0 && _col == 0)
+        flags |= FRAME_COMPLETE;
+
+    budget = page_budget + 3 + FRAME_END_LENGTH;
+    payload[0] = _seq++;
+    payload[1] = flags;
+    sendRecord(RecordType::FrameEnd, payload, FRAME_END_LENGTH, budget);
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+#include "Game.h"
+#include "SerialLink.h"
+
+#if FRAME_STREAM_ENABLED
+
+#define SCREEN_PAGES (HEIGHT / 8)
+
+// sends the screen over USB serial, one 8 pixel high page at a time. only pages
+// whose hash changed since they were last sent go out, PackBits compressed and
+// never more than FRAME_STREAM_BYTES_PER_FRAME per frame. a page that doesn't fit
+// carries on from the same column next frame. a state change resends every page
+class FrameStream {
+    public:
+        FrameStream(Arduboy2*);
+        void send(GameState state);
+
+    private:
+        uint32_t pageHash(uint8_t page);
+        uint8_t encode(const uint8_t *page, uint8_t &col, uint8_t *out, uint8_t max_out);
+
+        Arduboy2 *_arduboy;
+        uint32_t _sent_hash[SCREEN_PAGES]; // hash of each page when it was last sent
+        uint32_t _sending_hash;            // hash of _page when it started going out
+        uint8_t _stale;    // one bit per page that has to be sent whatever its hash
+        uint8_t _page;     // next page to look at, round robin so none is starved
+        uint8_t _col;      // next column of _page to send, 0 when it hasn't started
+        bool _torn;        // _page changed while it went out, the host has parts of different frames
+        uint8_t _seq;
+        GameState _last_state;
+};
+
+extern FrameStream frame_stream;
+
+#define FRAME_STREAM_SEND(state) frame_stream.send(state)
+
+#else
+
+#define FRAME_STREAM_SEND(state)
+
+#endif
@@ -1,6 +1,8 @@
 #include <Arduboy2.h>
 #include "Game.h"
-#include "assets/Sounds.h"
+#include "Animation.h"
+#include "Particles.h"
+#include "SpawnScheduler.h"
 #include "assets/BallThrowSprite.h"
 #include "assets/DogTailWagSprite.h"
 #include "assets/DogRunningSprite.h"
@@ -13,8 +15,29 @@
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define STATUS_BAR_HEIGHT 8
-#define NUM_GRASS 6
-#define GRASS_SPEED 3
+#define TICK_MS 33 // length of a game tick. timers and animations count ticks, not frames
+#define GRASS_SPEED (3 * FIXED_ONE)
+#define SCROLL_SPEED_RAMP 3 // added to max_scroll_speed per ball, about 1px/tick every 21 balls
+#define MAX_SCROLL_SPEED (16 * FIXED_ONE)
+#define WAVE_LENGTH 64 // entries in squirrel_wave, a power of 2 so phases wrap with a mask
+#define WAVE_HEIGHT 6  // pixels squirrel_wave swings above and below 0
+#define WEAVE_STEP 2   // phase steps per tick, a weave takes 32 ticks
+#define HOP_STEP 4     // a hop is half a wave, 8 ticks
+#define DASH_STEP 2
+#define MOVE_UNLOCK_SCORE 10 // another kind of squirrel movement every 10 balls
+#define BARK_BURST_PARTICLES 8
+#define BALL_BURST_PARTICLES 6
+#define BURST_SPEED (FIXED_ONE * 3 / 4) // pixels per tick
+#define BURST_LIFE 8   // ticks
+
+// animators. the start menu's come first, then the game's, so each state ticks its own range
+#define ANIM_TAIL_WAG 0
+#define ANIM_DOG_RUN 1
+#define ANIM_DOG_BARK 2
+#define ANIM_BALL 3
+#define ANIM_SQUIRREL 4
+#define NUM_ANIMATIONS 5
+#define NUM_GAME_ANIMATIONS (NUM_ANIMATIONS - ANIM_DOG_RUN)
 
 template <typename T>
 T clamp(T num, T min, T max)
@@ -28,139 +51,201 @@ T clamp(T num, T min, T max)
 }
 
 Arduboy2 *_arduboy;
-ArduboyPlaytune *_tunes;
+AudioOut *_tunes;
+SoundQueue *_sounds;
 bool volume_on = true;
+uint16_t sim_step = TICK_ONE; // frame length in ticks, 8.8 fixed point
+uint8_t tick_fraction = 0;     // fractional tick left over from previous frames
+uint8_t frame_ticks = 0;       // whole ticks that passed this frame
 GameState game_state = GameState::StartMenu;
-GameState last_game_state = game_state; // for knowing which state to go back to when exiting help menu
-uint8_t dog_speed_x = 3;
-uint8_t dog_speed_y = 2;
-
-int8_t ball_throw_frame_counter = 0;
-int8_t dog_tail_wag_frame_counter = 0;
-int8_t dog_tail_wag_frame_incr = 1; // toggles between 1 and -1 to play sprite in forward & reverse
-int8_t dog_running_frame_counter = 0;
-int8_t dog_bark_frame_counter = 0;
-int8_t ball_frame_counter = 0;
-int8_t squirrel_frame_counter = 0;
+GameState next_game_state = game_state; // state to switch to once this frame's update is done
+GameState help_return_state = game_state; // for knowing which state to go back to when exiting help menu
+fixed10_6 dog_speed_x = 3 * FIXED_ONE;
+fixed10_6 dog_speed_y = 2 * FIXED_ONE;
+
+int8_t ball_throw_frame_counter = 0; // follows the A button, so it isn't an animator
+uint8_t dog_bark_ticks = 0;
+
+const AnimationDef PROGMEM tail_wag_anim = {dog_tail_wag_max_frame + 1, AnimMode::PingPong, 1};
+const AnimationDef PROGMEM dog_run_anim = {dog_running_max_frame + 1, AnimMode::Loop, 1};
+const AnimationDef PROGMEM dog_bark_anim = {dog_bark_max_frame + 1, AnimMode::Loop, 1};
+const AnimationDef PROGMEM ball_anim = {ball_sprite_max_frame + 1, AnimMode::Loop, 1};
+const AnimationDef PROGMEM squirrel_anim = {squirrel_max_frame + 1, AnimMode::Loop, 1};
+Animator animators[NUM_ANIMATIONS];
+
+// one period of a sine wave, WAVE_HEIGHT pixels high. squirrels move by the difference
+// between two entries, so a move is a couple of table reads and an add
+const int8_t PROGMEM squirrel_wave[WAVE_LENGTH] = {
+    0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1,
+    0, -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -5, -6, -6, -6, -6, -6, -6, -6, -6, -6, -5, -5, -5, -4, -4, -3, -3, -2, -2, -1, -1,
+};
 
 uint8_t dog_bark_duration = 10;
-uint8_t max_scroll_speed = 2;
-uint8_t squirrel_spawn_chance = 3; // chance (out of 255) to spawn a squirrel per frame
-uint8_t ball_spawn_chance = 4;     // chance (out of 255) to spawn a ball per frame
+fixed10_6 max_scroll_speed = 2 * FIXED_ONE;
+uint8_t squirrel_spawn_chance = 3; // chance (out of 255) to spawn a squirrel per tick
+uint8_t ball_spawn_chance = 4;     // chance (out of 255) to spawn a ball per tick
+SpawnScheduler squirrel_spawner;
+SpawnScheduler ball_spawner;
 
 bool ready_to_throw = false;
 bool ball_thrown = false;
-int16_t dog_x = 0;
-int16_t dog_y = (SCREEN_HEIGHT / 2) - (dog_running_sprite_height / 2);
+fixed10_6 dog_x = 0;
+fixed10_6 dog_y = pixelToFixed((SCREEN_HEIGHT / 2) - (dog_running_sprite_height / 2));
 bool dog_barking = false;
-Entity squirrels[10];
-Entity balls[10];
+Entity squirrels[MAX_SQUIRRELS];
+Entity balls[MAX_BALLS];
 Grass grass[NUM_GRASS];
+ParticlePool particles;
 bool lost = false;
-uint8_t lost_frames = 60;     // when lose, count down to 0 while flashing the dog sprite
+uint8_t lost_frames = 60;     // when lose, count down to 0 (in ticks) while flashing the dog sprite
 uint8_t lost_game_flash = 10; // decrements to 0. when above 5, sprite=on, when below 5, sprite=off
 uint16_t score = 0;
+uint16_t spawn_count = 0;
+uint16_t bark_count = 0;
 uint8_t num_barks = 3;
 uint8_t bark_refill_start = 120;
-uint8_t bark_refill = bark_refill_start; // counts down every frame. when reaches 0, gain a bark
+uint8_t bark_refill = bark_refill_start; // counts down every tick. when reaches 0, gain a bark
+
+// handlers for each state, in GameState order. enter gets the state being left and
+// resets whatever the state owns. enter and exit may be nullptr
+const StateHandlers Game::state_table[] PROGMEM = {
+    {Game::enterStartMenu, nullptr, Game::updateStartMenu, Game::drawStartMenu},
+    {Game::enterGame, nullptr, Game::updateGame, Game::drawGame},
+    {Game::enterHelpMenu, nullptr, Game::updateHelpMenu, Game::drawHelpMenu},
+    {nullptr, nullptr, Game::updateGameOver, Game::drawGameOver},
+};
+
+const StateHandlers *Game::handlers(GameState state)
+{
+    return &state_table[(uint8_t)state];
+}
 
-Game::Game(Arduboy2 *arduboy, ArduboyPlaytune *tunes)
+Game::Game(Arduboy2 *arduboy, AudioOut *tunes, SoundQueue *sounds)
 {
     _arduboy = arduboy;
     _tunes = tunes;
-    initGrass();
+    _sounds = sounds;
+}
+
+// call from setup() once the hardware is up and the random seed is set
+void Game::begin()
+{
+    enterStartMenu(GameState::StartMenu);
+}
+
+// the switch happens at the end of the frame's update, so a state never
+// sees its own enter hook run half way through its update
+void Game::changeState(GameState state)
+{
+    next_game_state = state;
+}
+
+void Game::applyStateChange()
+{
+    if (next_game_state == game_state)
+        return;
+
+    GameState previous = game_state;
+    game_state = next_game_state;
+
+    StateFn exit = (StateFn)pgm_read_ptr(&handlers(previous)->exit);
+    if (exit != nullptr)
+        exit();
+
+    EnterFn enter = (EnterFn)pgm_read_ptr(&handlers(game_state)->enter);
+    if (enter != nullptr)
+        enter(previous);
 }
 
 void Game::initGrass()
 {
     for (int i = 0; i < NUM_GRASS; i++)
     {
-        grass[i].x = random(0, SCREEN_WIDTH);
+        grass[i].x = pixelToFixed(random(0, SCREEN_WIDTH));
         grass[i].y = random(STATUS_BAR_HEIGHT, SCREEN_HEIGHT - grass_sprite_height);
         grass[i].frame = random(0, grass_sprite_max_frame + 1);
     }
 }
 
-void Game::update()
+void Game::setFrameRate(uint8_t fps)
+{
+    // Arduboy2 rounds the frame length down to whole milliseconds
+    sim_step = ((uint16_t)TICK_ONE * (1000 / fps)) / TICK_MS;
+}
+
+GameState Game::state()
 {
-    switch (game_state)
+    return game_state;
+}
+
+GameStats Game::stats()
+{
+    GameStats stats;
+    stats.squirrels = 0;
+    stats.balls = 0;
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
     {
-    case GameState::StartMenu:
-        updateStartMenu();
-        break;
-    case GameState::InHelp:
-        updateHelpMenu();
-        break;
-    case GameState::InGame:
-        updateGame();
-        break;
+        if (squirrels[i].alive)
+            stats.squirrels++;
+    }
+    for (uint8_t i = 0; i < MAX_BALLS; i++)
+    {
+        if (balls[i].alive)
+            stats.balls++;
     }
+    stats.spawns = spawn_count;
+    stats.barks = bark_count;
+    stats.score = score;
+    return stats;
+}
+
+void Game::update()
+{
+    uint16_t ticks = tick_fraction + sim_step;
+    frame_ticks = ticks >> 8;
+    tick_fraction = ticks & 0xFF;
+
+    StateFn update = (StateFn)pgm_read_ptr(&handlers(game_state)->update);
+    update();
+    applyStateChange();
+
+    _sounds->update();
 }
 
 void Game::draw()
 {
-    switch (game_state)
-    {
-    case GameState::StartMenu:
-        drawStartMenu();
-        break;
-    case GameState::InHelp:
-        drawHelpMenu();
-        break;
-    case GameState::InGame:
-        drawGame();
-        break;
-    }
+    StateFn draw = (StateFn)pgm_read_ptr(&handlers(game_state)->draw);
+    draw();
 }
 
-void Game::resetGame()
+void Game::enterStartMenu(GameState from)
 {
-    game_state = GameState::StartMenu;
-    last_game_state = GameState::StartMenu;
+    // coming back from help carries on where the menu was
+    if (from == GameState::InHelp)
+        return;
 
     ball_throw_frame_counter = 0;
-    dog_tail_wag_frame_counter = 0;
-    dog_tail_wag_frame_incr = 1;
-    dog_running_frame_counter = 0;
-    dog_bark_frame_counter = 0;
-    ball_frame_counter = 0;
-    squirrel_spawn_chance = 5;
-    max_scroll_speed = 2;
-
+    startAnimation(animators[ANIM_TAIL_WAG], &tail_wag_anim);
     ready_to_throw = false;
     ball_thrown = false;
-    dog_x = 0;
-    dog_y = (SCREEN_HEIGHT / 2) - (dog_running_sprite_height / 2);
-    dog_barking = false;
+}
 
-    for (uint8_t i = 0; i < 10; i++)
-    {
-        squirrels[i] = Entity();
-        balls[i] = Entity();
-    }
-    initGrass();
+void Game::updateStartMenu()
+{
+    if (_arduboy->justPressed(B_BUTTON))
+        changeState(GameState::InHelp);
 
-    lost = false;
-    lost_frames = 60;
-    lost_game_flash = 10;
-    score = 0;
-    num_barks = 3;
-    bark_refill_start = 120;
-    bark_refill = bark_refill_start;
+    for (uint8_t t = 0; t < frame_ticks && next_game_state == GameState::StartMenu; t++)
+        tickStartMenu();
 }
 
-void Game::updateStartMenu()
+void Game::tickStartMenu()
 {
     // if we reach the last ball throw frame, start the game
     if (ball_throw_frame_counter >= ball_throw_max_frame)
     {
-        game_state = GameState::InGame;
-    }
-
-    if (_arduboy->justPressed(B_BUTTON))
-    {
-        game_state = GameState::InHelp;
-        last_game_state = GameState::StartMenu;
+        changeState(GameState::InGame);
+        return;
     }
 
     if (_arduboy->pressed(A_BUTTON))
@@ -179,7 +264,7 @@ void Game::updateStartMenu()
             if (ready_to_throw)
             {
                 ball_thrown = true;
-                _tunes->playScore(ball_throw_sound);
+                _sounds->request(Sfx::BallThrow);
             }
             else if (ball_throw_frame_counter > 0)
                 ball_throw_frame_counter--;
@@ -191,18 +276,13 @@ void Game::updateStartMenu()
         ball_throw_frame_counter++;
     }
 
-    // iterate forward/backward through dog tail wag frames
-    dog_tail_wag_frame_counter += dog_tail_wag_frame_incr;
-    if (dog_tail_wag_frame_counter >= dog_tail_wag_max_frame)
-        dog_tail_wag_frame_incr = -1;
-    else if (dog_tail_wag_frame_counter <= 0)
-        dog_tail_wag_frame_incr = 1;
+    tickAnimators(&animators[ANIM_TAIL_WAG], 1);
 }
 
 void Game::drawStartMenu()
 {
     Sprites::drawOverwrite(0, 0, ball_throw_sprite, ball_throw_frame_counter);
-    Sprites::drawOverwrite(60, 32, dog_tail_wag_sprite, dog_tail_wag_frame_counter);
+    Sprites::drawOverwrite(60, 32, dog_tail_wag_sprite, animators[ANIM_TAIL_WAG].frame);
 
     if (!ready_to_throw)
     {
@@ -220,10 +300,15 @@ void Game::drawStartMenu()
     }
 }
 
+void Game::enterHelpMenu(GameState from)
+{
+    help_return_state = from;
+}
+
 void Game::updateHelpMenu()
 {
     if (_arduboy->justPressed(B_BUTTON))
-        game_state = last_game_state;
+        changeState(help_return_state);
 
     if (_arduboy->justPressed(A_BUTTON))
         toggleVolume();
@@ -263,43 +348,127 @@ void Game::drawHelpMenu()
         Sprites::drawOverwrite(64, 46, volume_off_sprite, 0);
 }
 
+void Game::enterGame(GameState from)
+{
+    // coming back from help carries on with the same game
+    if (from == GameState::InHelp)
+        return;
+
+    startAnimation(animators[ANIM_DOG_RUN], &dog_run_anim);
+    stopAnimation(animators[ANIM_DOG_BARK]);
+    startAnimation(animators[ANIM_BALL], &ball_anim);
+    startAnimation(animators[ANIM_SQUIRREL], &squirrel_anim);
+    dog_bark_ticks = 0;
+    squirrel_spawn_chance = 3;
+    max_scroll_speed = 2 * FIXED_ONE;
+    squirrel_spawner.setChance(squirrel_spawn_chance);
+    ball_spawner.setChance(ball_spawn_chance);
+
+    dog_x = 0;
+    dog_y = pixelToFixed((SCREEN_HEIGHT / 2) - (dog_running_sprite_height / 2));
+    dog_barking = false;
+
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
+        squirrels[i].alive = false;
+    for (uint8_t i = 0; i < MAX_BALLS; i++)
+        balls[i].alive = false;
+    initGrass();
+
+    lost = false;
+    lost_frames = 60;
+    lost_game_flash = 10;
+    score = 0;
+    spawn_count = 0;
+    clearParticles(particles);
+    bark_count = 0;
+    num_barks = 3;
+    bark_refill_start = 120;
+    bark_refill = bark_refill_start;
+}
+
 void Game::updateGame()
 {
     if (lost)
     {
-        if (lost_frames == 0)
+        for (uint8_t t = 0; t < frame_ticks && lost_frames > 0; t++)
         {
-            if (_arduboy->anyPressed(A_BUTTON | B_BUTTON | UP_BUTTON | DOWN_BUTTON | LEFT_BUTTON | RIGHT_BUTTON))
-            {
-                resetGame();
-            }
+            lost_game_flash--;
+            if (lost_game_flash == 0)
+                lost_game_flash = 10;
+
+            lost_frames--;
         }
 
+        if (lost_frames == 0)
+            changeState(GameState::GameOver);
+
         return;
     }
 
+    // input is handled first so a press affects movement, collisions
+    // and the bark hitbox in the same frame it's drawn
+    handleGameInput();
+    simulateGame();
+    collideGame();
+
+    for (uint8_t t = 0; t < frame_ticks; t++)
+        animateGame();
+}
+
+void Game::handleGameInput()
+{
     if (_arduboy->justPressed(B_BUTTON))
+        changeState(GameState::InHelp);
+
+    const fixed10_6 min_x = pixelToFixed(STATUS_BAR_HEIGHT);
+    const fixed10_6 max_x = pixelToFixed(SCREEN_WIDTH - dog_running_sprite_width - dog_bark_sprite_width);
+    const fixed10_6 min_y = pixelToFixed(STATUS_BAR_HEIGHT);
+    const fixed10_6 max_y = pixelToFixed(SCREEN_HEIGHT - dog_running_sprite_height);
+
+    if (_arduboy->pressed(UP_BUTTON))
+        dog_y = clamp<fixed10_6>(dog_y - frameStep(dog_speed_y), min_y, max_y);
+    if (_arduboy->pressed(DOWN_BUTTON))
+        dog_y = clamp<fixed10_6>(dog_y + frameStep(dog_speed_y), min_y, max_y);
+    if (_arduboy->pressed(LEFT_BUTTON))
+        dog_x = clamp<fixed10_6>(dog_x - frameStep(dog_speed_x), min_x, max_x);
+    if (_arduboy->pressed(RIGHT_BUTTON))
+        dog_x = clamp<fixed10_6>(dog_x + frameStep(dog_speed_x), min_x, max_x);
+    if (!dog_barking && num_barks > 0)
     {
-        game_state = GameState::InHelp;
-        last_game_state = GameState::InGame;
+        if (_arduboy->justPressed(A_BUTTON))
+        {
+            _sounds->request(Sfx::Bark);
+            dog_barking = true;
+            startAnimation(animators[ANIM_DOG_BARK], &dog_bark_anim);
+            num_barks--;
+            bark_count++;
+        }
     }
+}
 
+void Game::simulateGame()
+{
     // move entities and un-alive them if off screen
-    for (uint8_t i = 0; i < 10; i++)
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
     {
         if (squirrels[i].alive)
         {
-            squirrels[i].x -= squirrels[i].speed;
-            if (squirrels[i].x < -16)
+            COUNT_WORK(1);
+            squirrels[i].x -= frameStep(squirrels[i].speed);
+            if (squirrels[i].x < pixelToFixed(-16))
             {
                 squirrels[i].alive = false;
             }
         }
+    }
 
+    for (uint8_t i = 0; i < MAX_BALLS; i++)
+    {
         if (balls[i].alive)
         {
-            balls[i].x -= balls[i].speed;
-            if (balls[i].x < -16)
+            COUNT_WORK(1);
+            balls[i].x -= frameStep(balls[i].speed);
+            if (balls[i].x < pixelToFixed(-16))
             {
                 balls[i].alive = false;
             }
@@ -309,71 +478,149 @@ void Game::updateGame()
     // update grass
     for (int i = 0; i < NUM_GRASS; i++)
     {
-        grass[i].x -= GRASS_SPEED;
+        COUNT_WORK(1);
+        grass[i].x -= frameStep(GRASS_SPEED);
 
-        if (grass[i].x < (0 - grass_sprite_width))
+        if (grass[i].x < pixelToFixed(0 - grass_sprite_width))
         {
-            grass[i].x = random(SCREEN_WIDTH, SCREEN_WIDTH * 2); // random off screen x location
+            grass[i].x = pixelToFixed(random(SCREEN_WIDTH, SCREEN_WIDTH * 2)); // random off screen x location
             grass[i].y = random(STATUS_BAR_HEIGHT, SCREEN_HEIGHT - grass_sprite_height);
             grass[i].frame = random(0, grass_sprite_max_frame + 1);
         }
     }
 
-    // chance to spawn squirrel
-    if (random(0, 255) < squirrel_spawn_chance)
+    for (uint8_t t = 0; t < frame_ticks; t++)
+        tickGame();
+}
+
+// spawning, squirrel movement patterns and bark refills happen once per tick, whatever the frame rate
+void Game::tickGame()
+{
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
+    {
+        if (squirrels[i].alive)
+        {
+            COUNT_WORK(1);
+            moveSquirrel(squirrels[i]);
+        }
+    }
+
+    // spawn a squirrel when one is due
+    if (squirrel_spawner.tick())
     {
         // find un-alive entity and ressurect them
-        for (uint8_t i = 0; i < 10; i++)
+        for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
         {
+            COUNT_WORK(1);
             if (squirrels[i].alive)
                 continue;
 
+            // more kinds of movement show up as the score goes up
+            uint8_t moves = min(1 + score / MOVE_UNLOCK_SCORE, NUM_SQUIRREL_MOVES);
+            SquirrelMove move = (SquirrelMove)random(0, moves);
+            // leave room above for squirrels that move up
+            uint8_t top = (move == SquirrelMove::Weave || move == SquirrelMove::Hop) ? WAVE_HEIGHT : 0;
+
             squirrels[i].alive = true;
-            squirrels[i].x = SCREEN_WIDTH;
-            squirrels[i].y = random(STATUS_BAR_HEIGHT, SCREEN_HEIGHT - 16);
-            squirrels[i].speed = random(1, max_scroll_speed + 1);
+            squirrels[i].x = pixelToFixed(SCREEN_WIDTH);
+            squirrels[i].y = random(STATUS_BAR_HEIGHT + top, SCREEN_HEIGHT - 16);
+            squirrels[i].speed = random(FIXED_ONE, max_scroll_speed + 1);
+            squirrels[i].move = move;
+            squirrels[i].phase = 0;
+            spawn_count++;
             break;
         }
     }
 
-    // chance to spawn ball
-    if (random(0, 255) < ball_spawn_chance)
+    // spawn a ball when one is due
+    if (ball_spawner.tick())
     {
         // find un-alive entity and ressurect them
-        for (uint8_t i = 0; i < 10; i++)
+        for (uint8_t i = 0; i < MAX_BALLS; i++)
         {
+            COUNT_WORK(1);
             if (balls[i].alive)
                 continue;
 
             balls[i].alive = true;
-            balls[i].x = SCREEN_WIDTH;
+            balls[i].x = pixelToFixed(SCREEN_WIDTH);
             balls[i].y = random(STATUS_BAR_HEIGHT, SCREEN_HEIGHT - 16);
-            balls[i].speed = random(1, max_scroll_speed + 1);
+            balls[i].speed = random(FIXED_ONE, max_scroll_speed + 1);
+            spawn_count++;
             break;
         }
     }
 
-    // check collisions with entities
-    for (uint8_t i = 0; i < 10; i++)
+    // regenerate barks over time
+    if (num_barks < 3)
     {
-        // 2 hitboxes for dog:
-        //   normal one for checking collisions with balls
-        //   smaller one for checking collisions with squirrels
-        Rect dog_hit_box = Rect(dog_x, dog_y, dog_running_sprite_width, dog_running_sprite_height);
-        Rect dog_hit_box_smaller = Rect(dog_x + 4, dog_y + 4, dog_running_sprite_width - 8, dog_running_sprite_height - 8);
-        Rect bark_hit_box = Rect(dog_x + dog_running_sprite_width - 6,
-                                 dog_y - 6,
-                                 dog_bark_sprite_width + 6,
-                                 dog_bark_sprite_height + 6);
-        Rect entity_hit_box;
+        bark_refill--;
+        if (bark_refill <= 0)
+        {
+            bark_refill = bark_refill_start;
+            num_barks++;
+        }
+    }
+}
 
+// y follows the wave by adding the change between the old and new phase,
+// so there's no base position to store and no multiply
+void Game::moveSquirrel(Entity &squirrel)
+{
+    uint8_t old_phase = squirrel.phase;
+    int8_t old_wave = pgm_read_byte(&squirrel_wave[old_phase]);
+    int8_t wave;
+
+    switch (squirrel.move)
+    {
+    case SquirrelMove::Straight:
+        break;
+    case SquirrelMove::Weave:
+        squirrel.phase = (old_phase + WEAVE_STEP) & (WAVE_LENGTH - 1);
+        wave = pgm_read_byte(&squirrel_wave[squirrel.phase]);
+        squirrel.y += wave - old_wave;
+        break;
+    case SquirrelMove::Hop:
+        // the height of a hop is the size of the wave, up is negative y
+        squirrel.phase = (old_phase + HOP_STEP) & (WAVE_LENGTH - 1);
+        wave = pgm_read_byte(&squirrel_wave[squirrel.phase]);
+        squirrel.y += abs(old_wave) - abs(wave);
+        break;
+    case SquirrelMove::Dash:
+        // up to WAVE_HEIGHT / 2 extra pixels a tick for the first half of the wave
+        squirrel.phase = (old_phase + DASH_STEP) & (WAVE_LENGTH - 1);
+        wave = pgm_read_byte(&squirrel_wave[squirrel.phase]);
+        if (wave > 0)
+            squirrel.x -= pixelToFixed(wave) >> 1;
+        break;
+    }
+}
+
+void Game::collideGame()
+{
+    // 2 hitboxes for dog:
+    //   normal one for checking collisions with balls
+    //   smaller one for checking collisions with squirrels
+    int16_t dog_px = fixedToPixel(dog_x);
+    int16_t dog_py = fixedToPixel(dog_y);
+    Rect dog_hit_box = Rect(dog_px, dog_py, dog_running_sprite_width, dog_running_sprite_height);
+    Rect dog_hit_box_smaller = Rect(dog_px + 4, dog_py + 4, dog_running_sprite_width - 8, dog_running_sprite_height - 8);
+    Rect bark_hit_box = Rect(dog_px + dog_running_sprite_width - 6,
+                             dog_py - 6,
+                             dog_bark_sprite_width + 6,
+                             dog_bark_sprite_height + 6);
+
+    Rect entity_hit_box;
+
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
+    {
         if (squirrels[i].alive)
         {
-            entity_hit_box = Rect(squirrels[i].x, squirrels[i].y, 16, 8);
+            entity_hit_box = Rect(fixedToPixel(squirrels[i].x), squirrels[i].y, 16, 8);
 
             if (_arduboy->collide(dog_hit_box_smaller, entity_hit_box))
             {
-                _tunes->playScore(lose_sound);
+                _sounds->request(Sfx::Lose);
                 lost = true;
             }
 
@@ -381,78 +628,51 @@ void Game::updateGame()
             if (dog_barking)
             {
                 if (_arduboy->collide(bark_hit_box, entity_hit_box))
+                {
                     squirrels[i].alive = false;
+                    burstParticles(particles, entity_hit_box.x + 8, entity_hit_box.y + 4,
+                                   BARK_BURST_PARTICLES, BURST_SPEED, BURST_LIFE);
+                }
             }
         }
+    }
 
+    for (uint8_t i = 0; i < MAX_BALLS; i++)
+    {
         if (balls[i].alive)
         {
-            entity_hit_box = Rect(balls[i].x, balls[i].y, ball_sprite_width, ball_sprite_height);
+            entity_hit_box = Rect(fixedToPixel(balls[i].x), balls[i].y, ball_sprite_width, ball_sprite_height);
 
             if (_arduboy->collide(dog_hit_box, entity_hit_box))
             {
-                _tunes->playScore(coin_collected_sound);
+                _sounds->request(Sfx::Coin);
                 increaseScoreAndDifficulty();
                 balls[i].alive = false;
+                burstParticles(particles, entity_hit_box.x + ball_sprite_width / 2,
+                               entity_hit_box.y + ball_sprite_height / 2,
+                               BALL_BURST_PARTICLES, BURST_SPEED, BURST_LIFE);
             }
         }
     }
+}
 
-    // regenerate barks over time
-    if (num_barks < 3)
-    {
-        bark_refill--;
-        if (bark_refill <= 0)
-        {
-            bark_refill = bark_refill_start;
-            num_barks++;
-        }
-    }
-
-    // if barking, update barking sprite
+void Game::animateGame()
+{
+    // the bark lasts dog_bark_duration ticks. this runs after collisions
+    // so a bark is active for the same number of ticks it always was
     if (dog_barking)
     {
-        dog_bark_frame_counter++;
-        if (dog_bark_frame_counter > dog_bark_duration)
+        dog_bark_ticks++;
+        if (dog_bark_ticks > dog_bark_duration)
         {
             dog_barking = false;
-            dog_bark_frame_counter = 0;
+            dog_bark_ticks = 0;
+            stopAnimation(animators[ANIM_DOG_BARK]);
         }
     }
 
-    // update running sprite
-    dog_running_frame_counter++;
-    if (dog_running_frame_counter > dog_running_max_frame)
-        dog_running_frame_counter = 0;
-
-    // update ball sprite
-    ball_frame_counter++;
-    if (ball_frame_counter > ball_sprite_max_frame)
-        ball_frame_counter = 0;
-
-    // update squirrel sprite
-    squirrel_frame_counter++;
-    if (squirrel_frame_counter > squirrel_max_frame)
-        squirrel_frame_counter = 0;
-
-    // Handle input
-    if (_arduboy->pressed(UP_BUTTON))
-        dog_y = clamp((int16_t)(dog_y - dog_speed_y), (int16_t)STATUS_BAR_HEIGHT, (int16_t)(SCREEN_HEIGHT - dog_running_sprite_height));
-    if (_arduboy->pressed(DOWN_BUTTON))
-        dog_y = clamp((int16_t)(dog_y + dog_speed_y), (int16_t)STATUS_BAR_HEIGHT, (int16_t)(SCREEN_HEIGHT - dog_running_sprite_height));
-    if (_arduboy->pressed(LEFT_BUTTON))
-        dog_x = clamp((int16_t)(dog_x - dog_speed_x), (int16_t)STATUS_BAR_HEIGHT, (int16_t)(SCREEN_WIDTH - dog_running_sprite_width - dog_bark_sprite_width));
-    if (_arduboy->pressed(RIGHT_BUTTON))
-        dog_x = clamp((int16_t)(dog_x + dog_speed_x), (int16_t)STATUS_BAR_HEIGHT, (int16_t)(SCREEN_WIDTH - dog_running_sprite_width - dog_bark_sprite_width));
-    if (!dog_barking && num_barks > 0)
-    {
-        if (_arduboy->justPressed(A_BUTTON))
-        {
-            _tunes->playScore(bark_sound);
-            dog_barking = true;
-            num_barks--;
-        }
-    }
+    tickAnimators(&animators[ANIM_DOG_RUN], NUM_GAME_ANIMATIONS);
+    tickParticles(particles);
 }
 
 void Game::increaseScoreAndDifficulty()
@@ -461,46 +681,41 @@ void Game::increaseScoreAndDifficulty()
 
     if (score % 10 == 0)
     {
-        squirrel_spawn_chance++;
+        if (squirrel_spawn_chance < 255)
+            squirrel_spawn_chance++;
+        squirrel_spawner.setChance(squirrel_spawn_chance);
         bark_refill_start += 20;
     }
 
-    if (score % 25 == 0)
-        max_scroll_speed++;
+    if (max_scroll_speed < MAX_SCROLL_SPEED)
+        max_scroll_speed += SCROLL_SPEED_RAMP;
 }
 
-void Game::drawGame()
+void Game::updateGameOver()
 {
-    if (lost)
-    {
-        if (lost_frames > 0)
-        {
-            lost_game_flash--;
-            if (lost_game_flash == 0)
-                lost_game_flash = 10;
-
-            lost_frames--;
-        }
-        else
-        {
-            _arduboy->setCursor(12, 16);
-            _arduboy->setTextSize(2);
-            _arduboy->println(F("Game Over"));
+    if (_arduboy->anyPressed(A_BUTTON | B_BUTTON | UP_BUTTON | DOWN_BUTTON | LEFT_BUTTON | RIGHT_BUTTON))
+        changeState(GameState::StartMenu);
+}
 
-            _arduboy->setTextSize(1);
-            _arduboy->setCursorX(16);
-            _arduboy->println(F("press any button"));
-            _arduboy->setCursorX(40);
-            _arduboy->print(F("to retry"));
+void Game::drawGameOver()
+{
+    _arduboy->setCursor(12, 16);
+    _arduboy->setTextSize(2);
+    _arduboy->println(F("Game Over"));
 
-            // still draw score on gameover screen
-            _arduboy->setCursor(96, 0);
-            _arduboy->print(score);
+    _arduboy->setTextSize(1);
+    _arduboy->setCursorX(16);
+    _arduboy->println(F("press any button"));
+    _arduboy->setCursorX(40);
+    _arduboy->print(F("to retry"));
 
-            return;
-        }
-    }
+    // still draw score on gameover screen
+    _arduboy->setCursor(96, 0);
+    _arduboy->print(score);
+}
 
+void Game::drawGame()
+{
     _arduboy->setTextSize(1);
     _arduboy->setCursor(0, 0);
     _arduboy->print(F("barks:"));
@@ -522,27 +737,29 @@ void Game::drawGame()
     // Draw grass
     for (auto g : grass)
     {
-        Sprites::drawSelfMasked(g.x, g.y, grass_sprite, g.frame);
+        Sprites::drawSelfMasked(fixedToPixel(g.x), g.y, grass_sprite, g.frame);
     }
 
     // Draw dog
     if (lost_game_flash > 5)
-        Sprites::drawSelfMasked(dog_x, dog_y, dog_running_sprite, dog_running_frame_counter);
+        Sprites::drawSelfMasked(fixedToPixel(dog_x), fixedToPixel(dog_y), dog_running_sprite, animators[ANIM_DOG_RUN].frame);
 
     if (dog_barking)
-        Sprites::drawSelfMasked(dog_x + 26, dog_y - 2, dog_bark_sprite, dog_bark_frame_counter % (dog_bark_max_frame + 1));
+        Sprites::drawSelfMasked(fixedToPixel(dog_x) + 26, fixedToPixel(dog_y) - 2, dog_bark_sprite, animators[ANIM_DOG_BARK].frame);
 
     // Draw squirrels
     for (auto squirrel : squirrels)
     {
         if (squirrel.alive)
-            Sprites::drawSelfMasked(squirrel.x, squirrel.y, squirrel_sprite, squirrel_frame_counter);
+            Sprites::drawSelfMasked(fixedToPixel(squirrel.x), squirrel.y, squirrel_sprite, animators[ANIM_SQUIRREL].frame);
     }
 
     // Draw balls
     for (auto ball : balls)
     {
         if (ball.alive)
-            Sprites::drawSelfMasked(ball.x, ball.y, ball_sprite, ball_frame_counter);
+            Sprites::drawSelfMasked(fixedToPixel(ball.x), ball.y, ball_sprite, animators[ANIM_BALL].frame);
     }
+
+    drawParticles(particles, _arduboy->getBuffer());
 }
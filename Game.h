@@ -1,41 +1,105 @@
-#include <Arduboy2.h>
-#include <ArduboyPlaytune.h>
-
-class Game {
-    public: 
-        Game(Arduboy2*, ArduboyPlaytune*);
-        void update();
-        void draw();
+#pragma once
 
-    private: 
-        void updateStartMenu();
-        void drawStartMenu();
-        void updateHelpMenu();
-        void drawHelpMenu();
-        void updateGame();
-        void drawGame();
-        void increaseScoreAndDifficulty();
-        void resetGame();
-        void initGrass();
-        void toggleVolume();
-};
+#include <Arduboy2.h>
+#include "Audio.h"
+#include "SoundQueue.h"
+#include "Fixed.h"
+#include "Config.h"
 
 enum class GameState
 {
     StartMenu,
     InGame,
     InHelp,
+    GameOver,
 };
 
+#define NUM_STATES 4
+
+typedef void (*StateFn)();
+typedef void (*EnterFn)(GameState from);
+
+struct StateHandlers {
+    EnterFn enter;
+    StateFn exit;
+    StateFn update;
+    StateFn draw;
+};
+
+// how a squirrel moves on top of running left at its speed
+enum class SquirrelMove : uint8_t
+{
+    Straight,
+    Weave, // drifts up and down
+    Hop,   // bounces up from where it spawned
+    Dash,  // bursts forward, then cruises
+};
+
+#define NUM_SQUIRREL_MOVES 4
+
+// x positions and speeds are fixed point (see Fixed.h), y positions are whole pixels.
+// move and phase are only used by squirrels
 struct Entity {
     bool alive;
-    int16_t x;
+    fixed10_6 x;
     int16_t y;
-    uint8_t speed;
+    fixed10_6 speed;
+    SquirrelMove move;
+    uint8_t phase; // position in squirrel_wave
+};
+
+// a snapshot of the current game. spawns, barks and score count from the start of the game
+struct GameStats {
+    uint8_t squirrels; // alive right now
+    uint8_t balls;
+    uint16_t spawns;   // squirrels and balls
+    uint16_t barks;
+    uint16_t score;
+};
+
+class Game {
+    public: 
+        Game(Arduboy2*, AudioOut*, SoundQueue*);
+        void begin();
+        void setFrameRate(uint8_t fps);
+        void update();
+        void draw();
+        GameState state();
+        GameStats stats();
+
+    private: 
+        // one entry per state, in GameState order
+        static const StateHandlers state_table[];
+        static const StateHandlers *handlers(GameState state);
+
+        static void enterStartMenu(GameState from);
+        static void updateStartMenu();
+        static void drawStartMenu();
+        static void enterHelpMenu(GameState from);
+        static void updateHelpMenu();
+        static void drawHelpMenu();
+        static void enterGame(GameState from);
+        static void updateGame();
+        static void drawGame();
+        static void updateGameOver();
+        static void drawGameOver();
+
+        static void changeState(GameState state);
+        static void applyStateChange();
+        static void tickStartMenu();
+        static void handleGameInput();
+        static void simulateGame();
+        static void tickGame();
+        static void moveSquirrel(Entity &squirrel);
+        static void collideGame();
+        static void animateGame();
+        static void increaseScoreAndDifficulty();
+        static void initGrass();
+        static void toggleVolume();
 };
 
 struct Grass {
-    int16_t x;
+    fixed10_6 x;
     int16_t y;
     uint8_t frame;
 };
\ No newline at end of file
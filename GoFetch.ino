@@ -1,35 +1,136 @@
 #include <Arduboy2.h>
-#include <ArduboyPlaytune.h>
+#include "Config.h"
+#include "Audio.h"
 #include "Game.h"
+#include "Profiler.h"
+#include "FrameScheduler.h"
+#include "FrameStream.h"
+#include "Power.h"
+#include "SerialLink.h"
+#include "SoundFx.h"
+#include "SoundQueue.h"
+#include "Telemetry.h"
 
 Arduboy2 arduboy;
-ArduboyPlaytune tunes(arduboy.audio.enabled);
+AudioOut tunes(arduboy.audio.enabled);
 
-Game game(&arduboy, &tunes);
+SweepPlayer sweeps(&tunes);
+SoundQueue sounds(&tunes, &sweeps);
+
+Game game(&arduboy, &tunes, &sounds);
+PowerManager power(&arduboy);
+
+#if ADAPTIVE_FRAME_RATE
+FrameScheduler frame_scheduler;
+uint8_t frame_rate = FRAME_RATE;
+#endif
+
+#if PROFILER_ENABLED
+Profiler profiler(&arduboy);
+#endif
+
+#if TELEMETRY_ENABLED
+Telemetry telemetry;
+#endif
+
+#if FRAME_STREAM_ENABLED
+FrameStream frame_stream(&arduboy);
+#endif
+
+#if AUDIO_MEASURE_ISR
+// show how many cycles per second the audio backend's interrupts take, then wait for a button
+void showIsrCycles()
+{
+    uint32_t cycles = measureIsrCycles(&tunes);
+
+    arduboy.clear();
+    arduboy.setCursor(0, 0);
+    arduboy.println(F("audio isr cycles/s"));
+    arduboy.println(cycles);
+    arduboy.println(F("press any button"));
+    arduboy.display();
+
+    while (!arduboy.anyPressed(A_BUTTON | B_BUTTON | UP_BUTTON | DOWN_BUTTON | LEFT_BUTTON | RIGHT_BUTTON))
+        ;
+    arduboy.waitNoButtons();
+}
+#endif
 
 void setup()
 {
-    // initialize the arduboy
-    arduboy.initRandomSeed();
+    // hardware first. this is Arduboy2's begin(), optionally without the boot logo
+#if SKIP_BOOT_LOGO
+    arduboy.boot();
+    arduboy.display();
+    arduboy.flashlight();
+    arduboy.systemButtons();
+    arduboy.audio.begin();
+    arduboy.waitNoButtons();
+#else
     arduboy.begin();
+#endif
     arduboy.audio.on();
-    arduboy.setFrameRate(30);
 
-    tunes.initChannel(PIN_SPEAKER_1);
-    tunes.initChannel(PIN_SPEAKER_2);
+    // seeding reads the ADC, which only works once the hardware is set up.
+    // each game state sets up its own data when it's entered, starting here
+#if RANDOM_SEED
+    randomSeed(RANDOM_SEED);
+#else
+    arduboy.initRandomSeed();
+#endif
+    game.begin();
+
+    arduboy.setFrameRate(FRAME_RATE);
+    game.setFrameRate(FRAME_RATE);
+    PROFILE_SET_FRAME_RATE(FRAME_RATE);
+
+    tunes.begin();
+    SERIAL_LINK_BEGIN();
+
+#if AUDIO_MEASURE_ISR
+    showIsrCycles();
+#endif
+
+    // every frame after this starts from the buffer display() cleared
+    arduboy.clear();
 }
 
 void loop()
 {
-    // pause render until it's time for the next frame
-    if (!(arduboy.nextFrame()))
-        return;
+    // wait for the next frame, the cpu idles in the meantime
+    power.waitForFrame(game.state());
 
-    arduboy.clear();
     arduboy.pollButtons();
+    power.update(game.state());
+    PROFILE_HANDLE_INPUT();
+    PROFILE_SET_SLEEP(power.sleepPercent(game.state()));
+    PROFILE_SET_SOUND_RESTARTS(sounds.restartsAvoided());
+    PROFILE_FRAME_START();
+    TELEMETRY_FRAME_START();
 
     game.update();
+    PROFILE_MARK(Update);
+    TELEMETRY_MARK_UPDATE();
     game.draw();
+    PROFILE_MARK(Draw);
+    TELEMETRY_MARK_DRAW();
+    PROFILE_DRAW_OVERLAY();
+    FRAME_STREAM_SEND(game.state());
 
-    arduboy.display();
+    // clears each byte of the buffer while the SPI hardware is still shifting it out,
+    // so the next frame's clear costs nothing. the buffer is empty after this
+    arduboy.display(CLEAR_BUFFER);
+    PROFILE_MARK(Display);
+    TELEMETRY_SEND(game.state(), game.stats());
+
+#if ADAPTIVE_FRAME_RATE
+    uint8_t next_frame_rate = frame_scheduler.update(game.state(), arduboy.cpuLoad());
+    if (next_frame_rate != frame_rate)
+    {
+        frame_rate = next_frame_rate;
+        arduboy.setFrameRate(frame_rate);
+        game.setFrameRate(frame_rate);
+        PROFILE_SET_FRAME_RATE(frame_rate);
+    }
+#endif
 }
@@ -0,0 +1,75 @@
+#include "Particles.h"
+
+#define NUM_DIRECTIONS 16
+#define GRAVITY 4 // added to vy every tick, 1/16 pixel per tick
+
+// unit vectors around a circle, 6 fractional bits
+const int8_t PROGMEM particle_directions[NUM_DIRECTIONS][2] = {
+    {64, 0}, {59, 24}, {45, 45}, {24, 59}, {0, 64}, {-24, 59}, {-45, 45}, {-59, 24},
+    {-64, 0}, {-59, -24}, {-45, -45}, {-24, -59}, {0, -64}, {24, -59}, {45, -45}, {59, -24},
+};
+
+void clearParticles(ParticlePool &pool)
+{
+    for (uint8_t i = 0; i < MAX_PARTICLES; i++)
+        pool.particles[i].life = 0;
+    pool.next = 0;
+}
+
+void burstParticles(ParticlePool &pool, int16_t x, int16_t y, uint8_t count, uint8_t speed, uint8_t life)
+{
+    // spread evenly around the circle from a random start, so bursts don't all look the same
+    uint8_t direction = random(0, NUM_DIRECTIONS);
+    uint8_t spacing = max(NUM_DIRECTIONS / count, 1);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        Particle &p = pool.particles[pool.next];
+        pool.next = (pool.next + 1) % MAX_PARTICLES;
+
+        p.x = pixelToFixed(x);
+        p.y = pixelToFixed(y);
+        p.vx = ((int8_t)pgm_read_byte(&particle_directions[direction][0]) * speed) >> 6;
+        p.vy = ((int8_t)pgm_read_byte(&particle_directions[direction][1]) * speed) >> 6;
+        p.life = life;
+
+        direction = (direction + spacing) % NUM_DIRECTIONS;
+    }
+}
+
+void tickParticles(ParticlePool &pool)
+{
+    for (uint8_t i = 0; i < MAX_PARTICLES; i++)
+    {
+        Particle &p = pool.particles[i];
+        if (p.life == 0)
+            continue;
+
+        COUNT_WORK(1);
+        p.life--;
+        p.x += p.vx;
+        p.y += p.vy;
+        if (p.vy < 127 - GRAVITY)
+            p.vy += GRAVITY;
+    }
+}
+
+// writes straight into the buffer instead of going through drawPixel()
+void drawParticles(const ParticlePool &pool, uint8_t *buffer)
+{
+    for (uint8_t i = 0; i < MAX_PARTICLES; i++)
+    {
+        const Particle &p = pool.particles[i];
+        if (p.life == 0)
+            continue;
+
+        uint16_t x = fixedToPixel(p.x);
+        uint16_t y = fixedToPixel(p.y);
+        // negative positions wrap to large values and fail the same check
+        if (x >= WIDTH || y >= HEIGHT)
+            continue;
+
+        COUNT_WORK(1);
+        buffer[(y >> 3) * WIDTH + x] |= 1 << (y & 7);
+    }
+}
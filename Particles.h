@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+#include "Fixed.h"
+
+// a one pixel particle. velocities have the same 6 fractional bits as positions,
+// in a byte, so up to 2 pixels per tick
+struct Particle {
+    fixed10_6 x;
+    fixed10_6 y;
+    int8_t vx; // per tick
+    int8_t vy;
+    uint8_t life; // ticks left, 0 when the slot is free
+};
+
+// a fixed ring of particles. a new particle always takes the slot after the last one,
+// so when the pool is full the oldest particle is the one that gets dropped
+struct ParticlePool {
+    Particle particles[MAX_PARTICLES];
+    uint8_t next;
+};
+
+void clearParticles(ParticlePool &pool);
+
+// count particles flying outwards from x, y (pixels) at speed (fixed point pixels
+// per tick, below 128)
+void burstParticles(ParticlePool &pool, int16_t x, int16_t y, uint8_t count, uint8_t speed, uint8_t life);
+
+// moves every live particle by one game tick, with a little gravity
+void tickParticles(ParticlePool &pool);
+
+// sets a pixel in the screen buffer for every live particle
+void drawParticles(const ParticlePool &pool, uint8_t *buffer);
@@ -0,0 +1,140 @@
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "Power.h"
+
+#define WAKE_MS 16 // the watchdog's shortest period, WDTO_15MS. how often a sleeping cpu checks the buttons
+
+// the watchdog only has to wake the cpu
+ISR(WDT_vect)
+{
+}
+
+// the watchdog in interrupt mode, without the reset
+static void startWatchdog()
+{
+    cli();
+    wdt_reset();
+    MCUSR &= ~_BV(WDRF);
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | WDTO_15MS;
+    sei();
+}
+
+PowerManager::PowerManager(Arduboy2 *arduboy)
+{
+    _arduboy = arduboy;
+    _last_input_ms = 0;
+
+#if PROFILER_ENABLED
+    _frame_start_us = 0;
+    for (uint8_t i = 0; i < NUM_STATES; i++)
+    {
+        _slept_us[i] = 0;
+        _total_us[i] = 0;
+    }
+#endif
+}
+
+// waits until it's time for the next frame. nextFrame() already idles the cpu while
+// a millisecond or more is left, same as a plain Arduboy2 loop, so the only thing
+// this adds is measuring the wait for the profiler
+void PowerManager::waitForFrame(GameState state)
+{
+#if PROFILER_ENABLED
+    unsigned long wait_start = micros();
+#else
+    (void)state;
+#endif
+
+    while (!_arduboy->nextFrame())
+        ;
+
+#if PROFILER_ENABLED
+    unsigned long now = micros();
+
+    uint8_t i = (uint8_t)state;
+    _slept_us[i] += now - wait_start;
+    _total_us[i] += now - _frame_start_us;
+    _frame_start_us = now;
+
+    // keep the totals from overflowing, older frames just count for less
+    if (_total_us[i] > 0x80000000UL)
+    {
+        _slept_us[i] >>= 1;
+        _total_us[i] >>= 1;
+    }
+#endif
+}
+
+// call after polling the buttons each frame
+void PowerManager::update(GameState state)
+{
+    if (_arduboy->buttonsState())
+    {
+        _last_input_ms = millis();
+        return;
+    }
+
+    if (state != GameState::InGame && millis() - _last_input_ms > DEEP_SLEEP_SECONDS * 1000UL)
+        deepSleep((uint8_t)state);
+}
+
+// turns the display off and powers the cpu down until any button is pressed. power
+// down stops every clock but the watchdog's, which wakes the cpu every WAKE_MS to check
+// the buttons. only A and B could raise a pin interrupt on the Arduboy, the d-pad can't.
+// the USB pll stops too, so USB is detached first and attached again after, when the
+// host sees the Arduboy come back. timer 0 stops with the cpu, so millis() misses the
+// time asleep. the frame timing and the audio timers just carry on from where they were
+void PowerManager::deepSleep(uint8_t i)
+{
+#if PROFILER_ENABLED
+    unsigned long sleep_start = micros();
+#else
+    (void)i;
+#endif
+    uint32_t wakes = 0;
+
+    _arduboy->displayOff();
+    USBDevice.detach();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    startWatchdog();
+
+    while (!_arduboy->buttonsState())
+    {
+        sleep_mode();
+        wakes++;
+    }
+
+    wdt_disable();
+    USBDevice.attach();
+    _arduboy->displayOn();
+
+    // don't let the wake up press do anything in the game
+    _arduboy->waitNoButtons();
+    _arduboy->pollButtons();
+    _last_input_ms = millis();
+
+#if PROFILER_ENABLED
+    // the time asleep counts as sleep for the screen that was showing. micros() stood still
+    // while powered down, the watchdog periods are what passed
+    uint32_t powered_down_us = wakes * WAKE_MS * 1000;
+    _slept_us[i] += micros() - sleep_start + powered_down_us;
+    _total_us[i] += powered_down_us;
+#else
+    (void)wakes;
+#endif
+}
+
+#if PROFILER_ENABLED
+// share of the time spent asleep while on a screen, out of 100
+uint8_t PowerManager::sleepPercent(GameState state)
+{
+    uint8_t i = (uint8_t)state;
+    uint32_t total = _total_us[i] / 100;
+    if (total == 0)
+        return 0;
+
+    return _slept_us[i] / total;
+}
+#endif
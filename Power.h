@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+#include "Game.h"
+
+// waits for each frame, timing the wait for the profiler, and turns the display
+// off after a while without input on the start menu, help or game over screens
+class PowerManager {
+    public:
+        PowerManager(Arduboy2*);
+        void waitForFrame(GameState state);
+        void update(GameState state);
+#if PROFILER_ENABLED
+        uint8_t sleepPercent(GameState state);
+#endif
+
+    private:
+        void deepSleep(uint8_t state_index);
+
+        Arduboy2 *_arduboy;
+        unsigned long _last_input_ms;
+#if PROFILER_ENABLED
+        unsigned long _frame_start_us;
+        uint32_t _slept_us[NUM_STATES]; // indexed by GameState
+        uint32_t _total_us[NUM_STATES];
+#endif
+};
@@ -0,0 +1,277 @@
+#include "Profiler.h"
+#include "StackMonitor.h"
+
+#if PROFILER_ENABLED
+
+#define WINDOW_FRAMES 32
+
+// overlay pages, in the order UP + DOWN cycles through them
+#define PAGE_OFF 0
+#define PAGE_LOAD 1
+#define PAGE_UPDATE 2  // min, avg and max of one phase each
+#define PAGE_DRAW 3
+#define PAGE_DISPLAY 4
+#define PAGE_RAM 5
+#define PAGE_SLEEP 6
+#define PAGE_BOOT_TIME 7
+#define PAGE_FRAME_HASH 8
+#define PAGE_RENDER_RATE 9
+#define PAGE_WORST_FRAME 10
+#define PAGE_SOUND_RESTARTS 11
+#define OVERLAY_PAGES 12
+
+Profiler::Profiler(Arduboy2 *arduboy)
+{
+    _arduboy = arduboy;
+    _frame_us = 33333;
+    _window_frames = 0;
+    _page = 0;
+    _sleep_percent = 0;
+    _sound_restarts = 0;
+    _boot_ms = 0;
+    _frame_cost_us = 0;
+    _worst_us = 0;
+
+    for (uint8_t i = 0; i < (uint8_t)Phase::Count; i++)
+    {
+        _cur_min[i] = 0xFFFF;
+        _cur_max[i] = 0;
+        _cur_sum[i] = 0;
+        _stats[i] = PhaseStats();
+    }
+}
+
+void Profiler::setFrameRate(uint8_t fps)
+{
+    _frame_us = 1000000UL / fps;
+}
+
+void Profiler::frameStart()
+{
+    _mark_us = micros();
+
+    // millis() counts from when the sketch started after reset
+    if (_boot_ms == 0)
+        _boot_ms = millis();
+}
+
+// records the time since the previous mark (or frame start) against a phase
+void Profiler::mark(Phase phase)
+{
+    unsigned long now = micros();
+    uint16_t elapsed = min(now - _mark_us, 0xFFFFUL);
+    _mark_us = now;
+
+    uint8_t i = (uint8_t)phase;
+    if (elapsed < _cur_min[i])
+        _cur_min[i] = elapsed;
+    if (elapsed > _cur_max[i])
+        _cur_max[i] = elapsed;
+    _cur_sum[i] += elapsed;
+
+    if (phase != Phase::Display)
+    {
+        _frame_cost_us = min((uint32_t)_frame_cost_us + elapsed, 0xFFFFUL);
+        return;
+    }
+
+    // display is the last phase of a frame
+    if (_frame_cost_us > _worst_us)
+        _worst_us = _frame_cost_us;
+    _frame_cost_us = 0;
+
+    if (++_window_frames >= WINDOW_FRAMES)
+        endWindow();
+}
+
+void Profiler::endWindow()
+{
+    for (uint8_t i = 0; i < (uint8_t)Phase::Count; i++)
+    {
+        _stats[i].min_us = _cur_min[i];
+        _stats[i].avg_us = _cur_sum[i] / _window_frames;
+        _stats[i].max_us = _cur_max[i];
+
+        _cur_min[i] = 0xFFFF;
+        _cur_max[i] = 0;
+        _cur_sum[i] = 0;
+    }
+
+    _window_frames = 0;
+}
+
+void Profiler::setSleepPercent(uint8_t percent)
+{
+    _sleep_percent = percent;
+}
+
+void Profiler::setSoundRestarts(uint16_t restarts)
+{
+    _sound_restarts = restarts;
+}
+
+// pressing UP and DOWN together flips to the next overlay page
+void Profiler::handleInput()
+{
+    if (_arduboy->pressed(UP_BUTTON | DOWN_BUTTON) &&
+        (_arduboy->justPressed(UP_BUTTON) || _arduboy->justPressed(DOWN_BUTTON)))
+    {
+        _page = (_page + 1) % OVERLAY_PAGES;
+    }
+}
+
+void Profiler::drawOverlay()
+{
+    if (_page == PAGE_OFF)
+        return;
+
+    // hash before the overlay covers part of the frame
+    uint16_t hash = 0;
+    if (_page == PAGE_FRAME_HASH)
+        hash = frameHash();
+
+    _arduboy->setTextSize(1);
+
+    // the phase timings need more room, so they cover the barks as well
+    if (_page >= PAGE_UPDATE && _page <= PAGE_DISPLAY)
+    {
+        _arduboy->fillRect(0, 0, 94, 8, BLACK);
+        _arduboy->setCursor(0, 0);
+        drawPhase((Phase)(_page - PAGE_UPDATE));
+        return;
+    }
+
+    _arduboy->fillRect(64, 0, 30, 8, BLACK);
+    _arduboy->setCursor(64, 0);
+
+    if (_page == PAGE_LOAD)
+        drawLoad();
+    else if (_page == PAGE_RAM)
+        drawRam();
+    else if (_page == PAGE_SLEEP)
+        drawSleep();
+    else if (_page == PAGE_BOOT_TIME)
+        drawBootTime();
+    else if (_page == PAGE_FRAME_HASH)
+        drawFrameHash(hash);
+    else if (_page == PAGE_RENDER_RATE)
+        drawRenderRate();
+    else if (_page == PAGE_WORST_FRAME)
+        drawWorstFrame();
+    else
+        drawSoundRestarts();
+}
+
+// cpu load as a number between the barks and the score, with a bar along the bottom
+// row of the status bar: the average update, draw and display time as a share of the frame
+void Profiler::drawLoad()
+{
+    _arduboy->print(_arduboy->cpuLoad());
+    _arduboy->print('%');
+
+    _arduboy->drawFastHLine(0, 7, WIDTH, BLACK);
+    uint8_t x = 0;
+    for (uint8_t i = 0; i < (uint8_t)Phase::Count; i++)
+    {
+        uint8_t width = min((uint32_t)_stats[i].avg_us * WIDTH / _frame_us, (uint32_t)(WIDTH - x));
+        // leave a 1 pixel gap between phases so they can be told apart
+        if (width > 1)
+            _arduboy->drawFastHLine(x, 7, width - 1, WHITE);
+        x += width;
+    }
+}
+
+// a phase's initial, then its min, avg and max over the last window in milliseconds
+void Profiler::drawPhase(Phase phase)
+{
+    const PhaseStats &stats = _stats[(uint8_t)phase];
+
+    _arduboy->print("udp"[(uint8_t)phase]);
+    printMs(stats.min_us);
+    printMs(stats.avg_us);
+    printMs(stats.max_us);
+}
+
+// a space, then whole and tenths of a millisecond
+void Profiler::printMs(uint16_t us)
+{
+    _arduboy->print(' ');
+    _arduboy->print(us / 1000);
+    _arduboy->print('.');
+    _arduboy->print((us / 100) % 10);
+}
+
+// bytes of RAM the stack has never reached since reset
+void Profiler::drawRam()
+{
+    _arduboy->print(stackHeadroom());
+    _arduboy->print('b');
+}
+
+// share of the time the cpu has slept on the current screen
+void Profiler::drawSleep()
+{
+    _arduboy->print('z');
+    _arduboy->print(_sleep_percent);
+    _arduboy->print('%');
+}
+
+// milliseconds from reset to the first frame
+void Profiler::drawBootTime()
+{
+    _arduboy->print(_boot_ms);
+    _arduboy->print('m');
+}
+
+// FNV-1a over the whole screen buffer, folded to 16 bits
+uint16_t Profiler::frameHash()
+{
+    const uint8_t *buffer = _arduboy->getBuffer();
+    uint32_t hash = 2166136261UL;
+
+    for (uint16_t i = 0; i < (WIDTH * HEIGHT / 8); i++)
+    {
+        hash ^= buffer[i];
+        hash *= 16777619UL;
+    }
+
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+// hash of what game.draw() rendered, as 4 hex digits. the same screen always gives the same hash
+void Profiler::drawFrameHash(uint16_t hash)
+{
+    for (int8_t shift = 12; shift >= 0; shift -= 4)
+    {
+        uint8_t digit = (hash >> shift) & 0x0F;
+        _arduboy->print((char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+    }
+}
+
+// how many frames per second draw() could render if it had the cpu to itself
+void Profiler::drawRenderRate()
+{
+    _arduboy->print('r');
+    if (_stats[(uint8_t)Phase::Draw].avg_us > 0)
+        _arduboy->print(1000000UL / _stats[(uint8_t)Phase::Draw].avg_us);
+    else
+        _arduboy->print('-');
+}
+
+// the slowest update() + draw() since reset, in milliseconds
+void Profiler::drawWorstFrame()
+{
+    _arduboy->print('w');
+    _arduboy->print(_worst_us / 1000);
+    _arduboy->print('.');
+    _arduboy->print((_worst_us / 100) % 10);
+}
+
+// sound requests SoundQueue dropped instead of restarting a sound, since reset
+void Profiler::drawSoundRestarts()
+{
+    _arduboy->print('s');
+    _arduboy->print(_sound_restarts);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+
+#if PROFILER_ENABLED
+
+enum class Phase : uint8_t
+{
+    Update,
+    Draw,
+    Display,
+    Count,
+};
+
+// min/avg/max of a phase over the last finished window, in microseconds
+struct PhaseStats {
+    uint16_t min_us;
+    uint16_t avg_us;
+    uint16_t max_us;
+};
+
+class Profiler {
+    public:
+        Profiler(Arduboy2*);
+        void setFrameRate(uint8_t fps);
+        void frameStart();
+        void mark(Phase);
+        void handleInput();
+        void drawOverlay();
+        void setSleepPercent(uint8_t percent);
+        void setSoundRestarts(uint16_t restarts);
+
+    private:
+        void endWindow();
+        void drawLoad();
+        void drawPhase(Phase phase);
+        void printMs(uint16_t us);
+        void drawRam();
+        void drawSleep();
+        void drawBootTime();
+        uint16_t frameHash();
+        void drawFrameHash(uint16_t hash);
+        void drawRenderRate();
+        void drawWorstFrame();
+        void drawSoundRestarts();
+
+        Arduboy2 *_arduboy;
+        uint16_t _frame_us;
+        unsigned long _mark_us;
+        uint8_t _window_frames;
+        uint8_t _page;
+        uint8_t _sleep_percent;
+        uint16_t _sound_restarts;
+        uint16_t _boot_ms; // reset to the start of the first frame
+        uint16_t _frame_cost_us; // update + draw so far this frame
+        uint16_t _worst_us;      // the highest _frame_cost_us since reset
+        uint16_t _cur_min[(uint8_t)Phase::Count];
+        uint16_t _cur_max[(uint8_t)Phase::Count];
+        uint32_t _cur_sum[(uint8_t)Phase::Count];
+        PhaseStats _stats[(uint8_t)Phase::Count];
+};
+
+extern Profiler profiler;
+
+#define PROFILE_SET_FRAME_RATE(fps) profiler.setFrameRate(fps)
+#define PROFILE_FRAME_START() profiler.frameStart()
+#define PROFILE_MARK(phase) profiler.mark(Phase::phase)
+#define PROFILE_HANDLE_INPUT() profiler.handleInput()
+#define PROFILE_DRAW_OVERLAY() profiler.drawOverlay()
+#define PROFILE_SET_SLEEP(percent) profiler.setSleepPercent(percent)
+#define PROFILE_SET_SOUND_RESTARTS(restarts) profiler.setSoundRestarts(restarts)
+
+#else
+
+#define PROFILE_SET_FRAME_RATE(fps)
+#define PROFILE_FRAME_START()
+#define PROFILE_MARK(phase)
+#define PROFILE_HANDLE_INPUT()
+#define PROFILE_DRAW_OVERLAY()
+#define PROFILE_SET_SLEEP(percent)
+#define PROFILE_SET_SOUND_RESTARTS(restarts)
+
+#endif
@@ -0,0 +1,36 @@
+#include "SerialLink.h"
+
+#if TELEMETRY_ENABLED || FRAME_STREAM_ENABLED
+
+// the baud rate doesn't matter over USB CDC
+void beginSerial()
+{
+    Serial.begin(9600);
+}
+
+// the largest payload that can be written right now without waiting for the host
+uint8_t recordSpace(uint8_t budget)
+{
+    int space = min(Serial.availableForWrite(), (int)min(budget, MAX_RECORD));
+    return space > 3 ? space - 3 : 0;
+}
+
+// writes a whole record or nothing. checking availableForWrite() first means
+// Serial.write() never has to wait for the host to read
+bool sendRecord(RecordType type, const uint8_t *payload, uint8_t length, uint8_t &budget)
+{
+    if (length > recordSpace(budget))
+        return false;
+
+    uint8_t record[MAX_RECORD];
+    record[0] = STREAM_SYNC;
+    record[1] = (uint8_t)type;
+    record[2] = length;
+    memcpy(&record[3], payload, length);
+
+    Serial.write(record, 3 + length);
+    budget -= 3 + length;
+    return true;
+}
+
+#endif
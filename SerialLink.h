@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+
+// records sent over USB serial by Telemetry and FrameStream. each one is
+// [STREAM_SYNC][type][length][payload], multi-byte fields are little endian.
+// tools/stream_decode.py reads them back
+#define STREAM_SYNC 0xA5
+
+// a record is written in one go, and the USB serial buffer only holds a 64 byte packet
+#define MAX_RECORD 64
+
+enum class RecordType : uint8_t
+{
+    Key = 1,      // telemetry: seq, update u16, draw u16, squirrels, balls, spawns u16, barks u16, score u16
+    Delta = 2,    // telemetry: seq, then the same fields as signed 8 bit changes since the last sent frame
+    Death = 3,    // telemetry: score u16 of the game that just ended
+    Page = 4,     // frame stream: page, first column, then PackBits compressed page bytes
+    FrameEnd = 5, // frame stream: seq, flags
+};
+
+void beginSerial();
+uint8_t recordSpace(uint8_t budget);
+bool sendRecord(RecordType type, const uint8_t *payload, uint8_t length, uint8_t &budget);
+
+// Telemetry and FrameStream share the port, it's opened once for both
+#if TELEMETRY_ENABLED || FRAME_STREAM_ENABLED
+#define SERIAL_LINK_BEGIN() beginSerial()
+#else
+#define SERIAL_LINK_BEGIN()
+#endif
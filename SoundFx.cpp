@@ -0,0 +1,79 @@
+#include "SoundFx.h"
+
+// frequencies (Hz) of MIDI notes 120-131. lower octaves are found by halving
+const uint16_t PROGMEM top_octave_frequencies[] = {8372, 8870, 9397, 9956, 10548, 11175,
+                                                   11840, 12544, 13290, 14080, 14917, 15804};
+
+uint16_t noteFrequency(uint8_t note)
+{
+    if (note > 127)
+        note = 127;
+
+    return pgm_read_word(&top_octave_frequencies[note % 12]) >> (10 - note / 12);
+}
+
+SweepPlayer::SweepPlayer(AudioOut *tunes)
+{
+    _tunes = tunes;
+    _playing = false;
+}
+
+void SweepPlayer::play(const SoundSweep *sweep)
+{
+    memcpy_P(&_sweep, sweep, sizeof(SoundSweep));
+
+    if (_sweep.step_ms == 0)
+        _sweep.step_ms = 1;
+
+    uint8_t span = abs(_sweep.end_note - _sweep.start_note);
+    uint8_t step_size = abs(_sweep.step);
+    _num_steps = (step_size == 0) ? 1 : (span / step_size) + 1;
+
+    _next_step = 0;
+    _playing = true;
+    update();
+}
+
+// each note is started to last until the end of the sweep, so it has to be silenced
+void SweepPlayer::stop()
+{
+    if (_playing)
+        _tunes->stopTone();
+
+    _playing = false;
+}
+
+bool SweepPlayer::playing()
+{
+    return _playing;
+}
+
+void SweepPlayer::update()
+{
+    if (!_playing)
+        return;
+
+    // notes play in turn, never skipped. a frame that comes late holds the note
+    // sounding now a little longer instead
+    unsigned long now = millis();
+    if (_next_step > 0 && now - _step_start_ms < _sweep.step_ms)
+        return;
+
+    if (_next_step >= _num_steps)
+    {
+        _playing = false;
+        return;
+    }
+
+    // keep to the sweep's timing, unless a note is more than a whole note late
+    if (_next_step == 0 || now - _step_start_ms >= 2 * _sweep.step_ms)
+        _step_start_ms = now;
+    else
+        _step_start_ms += _sweep.step_ms;
+
+    uint8_t note = _sweep.start_note + (int8_t)_next_step * _sweep.step;
+    _next_step++;
+
+    // held until the end of the sweep, so it sounds until the next update replaces it
+    _tunes->tone(noteFrequency(note), (uint16_t)(_num_steps - _next_step + 1) * _sweep.step_ms);
+}
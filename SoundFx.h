@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Audio.h"
+
+// a linear pitch sweep that is generated note by note while it plays,
+// instead of being unrolled into a score. notes are MIDI note numbers, same as in scores
+struct SoundSweep {
+    uint8_t start_note;
+    uint8_t end_note;
+    int8_t step;     // notes to move each step, the sign gives the direction
+    uint8_t step_ms; // how long each note is held. at least a 30 fps frame, 34 ms, see SweepPlayer
+};
+
+// plays a SoundSweep from PROGMEM. an alternative to playScore() for sweeps.
+// update() must be called once per frame and starts at most one note per call, so
+// every note gets played as long as none is shorter than a frame
+class SweepPlayer {
+    public:
+        SweepPlayer(AudioOut*);
+        void play(const SoundSweep*);
+        void stop();
+        void update();
+        bool playing();
+
+    private:
+        AudioOut *_tunes;
+        SoundSweep _sweep;
+        uint8_t _num_steps;
+        uint8_t _next_step;
+        unsigned long _step_start_ms; // when the note sounding now was due
+        bool _playing;
+};
+
+uint16_t noteFrequency(uint8_t note);
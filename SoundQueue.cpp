@@ -0,0 +1,73 @@
+#include "SoundQueue.h"
+#include "assets/Sounds.h"
+
+SoundQueue::SoundQueue(AudioOut *tunes, SweepPlayer *sweeps)
+{
+    _tunes = tunes;
+    _sweeps = sweeps;
+    _pending = Sfx::None;
+    _current = Sfx::None;
+    _restarts_avoided = 0;
+}
+
+void SoundQueue::request(Sfx sfx)
+{
+    // only one sound per frame gets played, every extra request is a restart we skip
+    if (_pending != Sfx::None)
+        _restarts_avoided++;
+
+    if (sfx > _pending)
+        _pending = sfx;
+}
+
+void SoundQueue::update()
+{
+    if (_pending != Sfx::None)
+    {
+        bool busy = _tunes->playing() || _sweeps->playing();
+        if (busy && _current > _pending)
+            _restarts_avoided++;
+        else
+            play(_pending);
+
+        _pending = Sfx::None;
+    }
+
+    _sweeps->update();
+    // steps the BEEP backend's scores and ends its timed tones. nothing for Playtune
+    _tunes->update();
+}
+
+uint16_t SoundQueue::restartsAvoided()
+{
+    return _restarts_avoided;
+}
+
+// a new sound replaces whatever is playing. the BEEP backend has a single voice,
+// so a sweep left running would cut off a score on its next step, and the other way round
+void SoundQueue::play(Sfx sfx)
+{
+    _current = sfx;
+
+    switch (sfx)
+    {
+    case Sfx::BallThrow:
+        _tunes->stopScore();
+        _sweeps->play(&ball_throw_sweep);
+        break;
+    case Sfx::Coin:
+        _sweeps->stop();
+        _tunes->playScore(coin_collected_sound);
+        break;
+    case Sfx::Bark:
+        _tunes->stopScore();
+        _sweeps->play(&bark_sweep);
+        break;
+    case Sfx::Lose:
+        _sweeps->stop();
+        _tunes->playScore(lose_sound);
+        break;
+    case Sfx::None:
+        break;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Audio.h"
+#include "SoundFx.h"
+
+// sound effects, ordered by priority (higher value wins)
+enum class Sfx : uint8_t
+{
+    None,
+    BallThrow,
+    Coin,
+    Bark,
+    Lose,
+};
+
+// collects sound requests made during a frame and starts at most one of them in update().
+// update() also drives the sweep player and the audio backend, so call it once per frame
+// a request never cuts off a higher priority sound that is still playing
+class SoundQueue {
+    public:
+        SoundQueue(AudioOut*, SweepPlayer*);
+        void request(Sfx);
+        void update();
+        uint16_t restartsAvoided();
+
+    private:
+        void play(Sfx);
+
+        AudioOut *_tunes;
+        SweepPlayer *_sweeps;
+        Sfx _pending;
+        Sfx _current;
+        uint16_t _restarts_avoided;
+};
@@ -0,0 +1,75 @@
+#include "SpawnScheduler.h"
+#include "Config.h"
+
+#define EXP_BUCKETS 64
+#define EXP_TAIL (EXP_BUCKETS - 1)
+#define EXP_TAIL_START 1065 // ln(64), 8 fractional bits. where the last bucket starts
+#define EVERY_TICK 0xFFFFFFFFUL
+
+// an exponential distribution split into 64 equally likely buckets, as the mean
+// of each bucket with 8 fractional bits. the last, open ended bucket isn't stored:
+// the exponential is memoryless, so landing in it adds EXP_TAIL_START and draws again
+const uint16_t PROGMEM exp_bucket_means[EXP_BUCKETS - 1] = {
+    2, 6, 10, 14, 19, 23, 27, 32, 36, 41, 46, 51, 56, 61, 66, 71,
+    76, 82, 87, 93, 99, 105, 111, 117, 124, 130, 137, 144, 151, 158, 166, 173,
+    181, 190, 198, 207, 216, 226, 236, 246, 257, 268, 279, 291, 304, 318, 332, 347,
+    363, 380, 398, 418, 440, 463, 488, 517, 549, 586, 629, 680, 745, 832, 966,
+};
+
+SpawnScheduler::SpawnScheduler()
+{
+    _rate = 0;
+    _ticks = 0;
+}
+
+// a roll that passes with chance p waits floor(E / -ln(1 - p)) + 1 ticks for its
+// first pass, with E exponential. -ln(1 - p) is p + p^2/2 + p^3/3 + ..., three terms
+// are within 1% up to p = 1/4, and spawn chances stay well under that
+void SpawnScheduler::setChance(uint8_t chance)
+{
+    if (chance == 0)
+    {
+        _rate = 0;
+        _ticks = 0;
+        return;
+    }
+
+    if (chance == 255)
+    {
+        _rate = EVERY_TICK;
+    }
+    else
+    {
+        uint32_t p = ((uint32_t)chance << 16) / 255;
+        uint32_t p2 = (p * p) >> 16;
+        uint32_t p3 = (p2 * p) >> 16;
+        _rate = p + p2 / 2 + p3 / 3;
+    }
+
+    // the wait is memoryless, so starting a new one at the new rate is the same as carrying on
+    schedule();
+}
+
+void SpawnScheduler::schedule()
+{
+    uint32_t e = 0;
+    uint8_t bucket = random(0, EXP_BUCKETS);
+    while (bucket == EXP_TAIL)
+    {
+        e += EXP_TAIL_START;
+        bucket = random(0, EXP_BUCKETS);
+    }
+    e += pgm_read_word(&exp_bucket_means[bucket]);
+
+    _ticks = min((e << 8) / _rate + 1, 0xFFFFUL);
+}
+
+bool SpawnScheduler::tick()
+{
+    COUNT_WORK(1);
+    if (_ticks == 0 || --_ticks > 0)
+        return false;
+
+    schedule();
+    return true;
+}
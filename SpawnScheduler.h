@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduboy2.h>
+
+// counts down to the next spawn instead of rolling random(0, 255) < chance every tick.
+// the wait is drawn from the same geometric distribution the rolls give, so spawns
+// come just as often, but random() only runs once per spawn
+class SpawnScheduler {
+    public:
+        SpawnScheduler();
+        void setChance(uint8_t chance); // out of 255 per tick. 0 never spawns
+        bool tick();                    // true on the tick a spawn is due
+
+    private:
+        void schedule();
+
+        uint32_t _rate;  // -ln(1 - chance / 255), 16 fractional bits
+        uint16_t _ticks; // until the next spawn, 0 when spawning is off
+};
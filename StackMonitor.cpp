@@ -0,0 +1,29 @@
+#include "StackMonitor.h"
+
+#if PROFILER_ENABLED
+
+#define STACK_PAINT 0xC5
+
+extern uint8_t __bss_end;
+extern uint8_t __stack;
+
+// .init3 runs after the stack pointer is set up and before .data/.bss are initialized
+// or any constructor runs, so nothing below RAMEND is in use yet
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack()
+{
+    uint8_t *p = &__bss_end;
+    while (p <= &__stack)
+        *p++ = STACK_PAINT;
+}
+
+uint16_t stackHeadroom()
+{
+    const uint8_t *p = &__bss_end;
+    while (p <= &__stack && *p == STACK_PAINT)
+        p++;
+
+    return p - &__bss_end;
+}
+
+#endif
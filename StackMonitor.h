@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+
+#if PROFILER_ENABLED
+
+// free RAM between the end of .bss and the stack is painted with a known byte at startup,
+// so the deepest the stack has ever reached can be found by looking for the first byte
+// that isn't paint anymore
+
+// bytes between .bss and the deepest the stack has been since reset
+uint16_t stackHeadroom();
+
+#endif
@@ -0,0 +1,128 @@
+#include "Telemetry.h"
+
+#if TELEMETRY_ENABLED
+
+#define KEY_INTERVAL 32 // frames between key frames, so a decoder can join mid stream
+#define KEY_LENGTH 13
+#define DELTA_LENGTH 8
+#define DEATH_LENGTH 2
+
+static void putWord(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static bool fitsInt8(int32_t value)
+{
+    return value >= -128 && value <= 127;
+}
+
+Telemetry::Telemetry()
+{
+    _seq = 0;
+    _since_key = 0;
+    _have_key = false;
+    _death_pending = false;
+    _last_state = GameState::StartMenu;
+}
+
+void Telemetry::frameStart()
+{
+    _mark_us = micros();
+}
+
+void Telemetry::markUpdate()
+{
+    unsigned long now = micros();
+    _update_ticks = min((now - _mark_us) / 4, 0xFFFFUL);
+    _mark_us = now;
+}
+
+void Telemetry::markDraw()
+{
+    unsigned long now = micros();
+    _draw_ticks = min((now - _mark_us) / 4, 0xFFFFUL);
+    _mark_us = now;
+}
+
+// call once per frame after draw()
+void Telemetry::send(GameState state, const GameStats &stats)
+{
+    uint8_t budget = TELEMETRY_BYTES_PER_FRAME;
+
+    if (state == GameState::GameOver && _last_state == GameState::InGame)
+    {
+        _death_pending = true;
+        _death_score = stats.score;
+    }
+    _last_state = state;
+
+    // a death is sent once, so it keeps trying until it gets through
+    if (_death_pending)
+        sendDeath(budget);
+
+    sendFrame(stats, budget);
+}
+
+void Telemetry::sendFrame(const GameStats &stats, uint8_t &budget)
+{
+    uint8_t payload[KEY_LENGTH];
+    uint8_t seq = _seq++;
+
+    int32_t deltas[7] = {
+        (int32_t)_update_ticks - _sent_update,
+        (int32_t)_draw_ticks - _sent_draw,
+        (int32_t)stats.squirrels - _sent.squirrels,
+        (int32_t)stats.balls - _sent.balls,
+        (int32_t)stats.spawns - _sent.spawns,
+        (int32_t)stats.barks - _sent.barks,
+        (int32_t)stats.score - _sent.score,
+    };
+
+    bool key = !_have_key || _since_key >= KEY_INTERVAL;
+    for (uint8_t i = 0; i < 7 && !key; i++)
+    {
+        if (!fitsInt8(deltas[i]))
+            key = true;
+    }
+
+    bool sent;
+    payload[0] = seq;
+    if (key)
+    {
+        putWord(&payload[1], _update_ticks);
+        putWord(&payload[3], _draw_ticks);
+        payload[5] = stats.squirrels;
+        payload[6] = stats.balls;
+        putWord(&payload[7], stats.spawns);
+        putWord(&payload[9], stats.barks);
+        putWord(&payload[11], stats.score);
+        sent = sendRecord(RecordType::Key, payload, KEY_LENGTH, budget);
+    }
+    else
+    {
+        for (uint8_t i = 0; i < 7; i++)
+            payload[1 + i] = (int8_t)deltas[i];
+        sent = sendRecord(RecordType::Delta, payload, DELTA_LENGTH, budget);
+    }
+
+    if (!sent)
+        return;
+
+    _sent_update = _update_ticks;
+    _sent_draw = _draw_ticks;
+    _sent = stats;
+    _since_key = key ? 0 : _since_key + 1;
+    _have_key = true;
+}
+
+void Telemetry::sendDeath(uint8_t &budget)
+{
+    uint8_t payload[DEATH_LENGTH];
+    putWord(payload, _death_score);
+    if (sendRecord(RecordType::Death, payload, DEATH_LENGTH, budget))
+        _death_pending = false;
+}
+
+#endif
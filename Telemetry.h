@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduboy2.h>
+#include "Config.h"
+#include "Game.h"
+#include "SerialLink.h"
+
+#if TELEMETRY_ENABLED
+
+// sends one frame record per frame without ever waiting on the host. a record that
+// doesn't fit in the frame's byte budget or the USB buffer is dropped, and the gap
+// shows up in the sequence numbers. deltas are always against the last record sent.
+// times are in 4 us steps, the resolution of micros()
+class Telemetry {
+    public:
+        Telemetry();
+        void frameStart();
+        void markUpdate();
+        void markDraw();
+        void send(GameState state, const GameStats &stats);
+
+    private:
+        void sendFrame(const GameStats &stats, uint8_t &budget);
+        void sendDeath(uint8_t &budget);
+
+        unsigned long _mark_us;
+        uint16_t _update_ticks; // this frame's times, in 4 us steps
+        uint16_t _draw_ticks;
+        uint8_t _seq;
+        uint8_t _since_key;    // frames sent since the last key frame
+        bool _have_key;        // false until a key frame got through
+        bool _death_pending;
+        uint16_t _death_score;
+        GameState _last_state;
+
+        // the last frame that was sent, for deltas
+        uint16_t _sent_update;
+        uint16_t _sent_draw;
+        GameStats _sent;
+};
+
+extern Telemetry telemetry;
+
+#define TELEMETRY_FRAME_START() telemetry.frameStart()
+#define TELEMETRY_MARK_UPDATE() telemetry.markUpdate()
+#define TELEMETRY_MARK_DRAW() telemetry.markDraw()
+#define TELEMETRY_SEND(state, stats) telemetry.send(state, stats)
+
+#else
+
+#define TELEMETRY_FRAME_START()
+#define TELEMETRY_MARK_UPDATE()
+#define TELEMETRY_MARK_DRAW()
+#define TELEMETRY_SEND(state, stats)
+
+#endif
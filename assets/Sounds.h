@@ -1,4 +1,4 @@
-#include <ArduboyPlaytune.h>
+#include "../SoundFx.h"
 
 const byte PROGMEM coin_collected_sound[] = {0x90,85, 0,25, 0x80,
                                              0x90,90, 0,100, 0x80, 0xf0};
@@ -8,44 +8,9 @@ const byte PROGMEM lose_sound[] = {0x90, 60, 0,0xC8, 0x80,
                                    0x90, 58, 0,0xC8, 0x80,
                                    0x90, 57, 0x02,0x58, 0x80, 0xf0};
 
-const byte PROGMEM ball_throw_sound[] = {0x90,120, 0,20, 0x80,
-                                         0x90,119, 0,20, 0x80,
-                                         0x90,118, 0,20, 0x80,
-                                         0x90,117, 0,20, 0x80,
-                                         0x90,116, 0,20, 0x80,
-                                         0x90,115, 0,20, 0x80,
-                                         0x90,114, 0,20, 0x80,
-                                         0x90,113, 0,20, 0x80,
-                                         0x90,112, 0,20, 0x80,
-                                         0x90,111, 0,20, 0x80,
-                                         0x90,110, 0,20, 0x80,
-                                         0x90,109, 0,20, 0x80,
-                                         0x90,108, 0,20, 0x80,
-                                         0x90,107, 0,20, 0x80,
-                                         0x90,106, 0,20, 0x80,
-                                         0x90,105, 0,20, 0x80,
-                                         0x90,104, 0,20, 0x80,
-                                         0x90,103, 0,20, 0x80,
-                                         0x90,102, 0,20, 0x80,
-                                         0x90,101, 0,20, 0x80, 0xf0};
+// 120 down to 102 in steps of 2, 40ms per note. notes at least a frame long all get
+// played, shorter ones would be skipped (see SweepPlayer). 400ms, as long as it always was
+const SoundSweep PROGMEM ball_throw_sweep = {120, 102, -2, 40};
 
-const byte PROGMEM bark_sound[] = {0x90,50, 0,10, 0x80,
-                                   0x90,51, 0,10, 0x80,
-                                   0x90,52, 0,10, 0x80,
-                                   0x90,53, 0,10, 0x80,
-                                   0x90,54, 0,10, 0x80,
-                                   0x90,55, 0,10, 0x80,
-                                   0x90,56, 0,10, 0x80,
-                                   0x90,57, 0,10, 0x80,
-                                   0x90,58, 0,10, 0x80,
-                                   0x90,59, 0,10, 0x80,
-                                   0x90,60, 0,10, 0x80,
-                                   0x90,61, 0,10, 0x80,
-                                   0x90,62, 0,10, 0x80,
-                                   0x90,63, 0,10, 0x80,
-                                   0x90,64, 0,10, 0x80,
-                                   0x90,65, 0,10, 0x80,
-                                   0x90,66, 0,10, 0x80,
-                                   0x90,67, 0,10, 0x80,
-                                   0x90,68, 0,10, 0x80,
-                                   0x90,69, 0,10, 0x80, 0xf0};
+// 50 up to 66 in steps of 4, 40ms per note. 200ms, as long as it always was
+const SoundSweep PROGMEM bark_sweep = {50, 66, 4, 40};
@@ -0,0 +1,560 @@
+#include <chrono>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Harness.h"
+#include "FrameStream.h"
+#include "Particles.h"
+#include "SerialLink.h"
+#include "SoundFx.h"
+#include "SoundQueue.h"
+#include "Telemetry.h"
+
+#define MAX_INCLUDE_DEPTH 8
+#define MAX_LATENCY_FRAMES 8
+
+extern ParticlePool particles;
+
+// the sketch's globals, as in GoFetch.ino
+Arduboy2 arduboy;
+AudioOut tunes(arduboy.audio.enabled);
+SweepPlayer sweeps(&tunes);
+SoundQueue sounds(&tunes, &sweeps);
+Game game(&arduboy, &tunes, &sounds);
+PowerManager power(&arduboy);
+
+#if TELEMETRY_ENABLED
+Telemetry telemetry;
+#endif
+
+#if FRAME_STREAM_ENABLED
+FrameStream frame_stream(&arduboy);
+#endif
+
+static uint8_t last_frame[WIDTH * HEIGHT / 8];
+
+// see startCapture()
+static FILE *capture_stats = nullptr;
+static std::string capture_frames; // directory, empty when not capturing
+static uint32_t captured_frames = 0;
+static uint8_t capture_seq = 0;
+static GameState capture_state = GameState::StartMenu;
+
+// where runScript() is, so frames can go by while the game waits inside a frame
+static const Script *running_script = nullptr;
+static RunResult *running_result = nullptr;
+static size_t next_step = 0;
+static uint32_t frames_left = 0; // of the current Frames step
+static uint8_t held_buttons = 0;
+static uint32_t waited_ms = 0;  // not yet a whole frame
+
+struct ScriptEnded {};
+
+static const char button_letters[] = "UDLRAB";
+static const uint8_t button_masks[] = {UP_BUTTON, DOWN_BUTTON, LEFT_BUTTON, RIGHT_BUTTON, A_BUTTON, B_BUTTON};
+static const char *const state_names[NUM_STATES] = {"StartMenu", "InGame", "InHelp", "GameOver"};
+
+static bool parseButtons(const char *text, uint8_t &buttons)
+{
+    buttons = 0;
+    if (strcmp(text, "-") == 0)
+        return true;
+
+    for (const char *c = text; *c; c++)
+    {
+        const char *letter = strchr(button_letters, *c);
+        if (letter == nullptr)
+            return false;
+
+        buttons |= button_masks[letter - button_letters];
+    }
+
+    return buttons != 0;
+}
+
+static std::string buttonText(uint8_t buttons)
+{
+    std::string text;
+    for (uint8_t i = 0; i < sizeof(button_masks); i++)
+    {
+        if (buttons & button_masks[i])
+            text += button_letters[i];
+    }
+
+    return text.empty() ? "-" : text;
+}
+
+bool loadScript(const char *path, Script &script)
+{
+    static uint8_t depth = 0;
+    if (depth >= MAX_INCLUDE_DEPTH)
+    {
+        fprintf(stderr, "%s: included too deep\n", path);
+        return false;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "%s: can't open\n", path);
+        return false;
+    }
+
+    char line[128];
+    unsigned line_number = 0;
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        line_number++;
+        char *hash = strchr(line, '#');
+        if (hash != nullptr)
+            *hash = '\0';
+
+        char word[32];
+        char arg[32];
+        char arg2[32];
+        int fields = sscanf(line, "%31s %31s %31s", word, arg, arg2);
+        if (fields <= 0)
+            continue;
+
+        ScriptStep step = {ScriptStep::Frames, 0, 0};
+        ok = fields == (strcmp(word, "latency") == 0 ? 3 : 2);
+
+        if (ok && strcmp(word, "seed") == 0)
+        {
+            step.kind = ScriptStep::Seed;
+            step.value = strtoul(arg, nullptr, 10);
+        }
+        else if (ok && strcmp(word, "fps") == 0)
+        {
+            step.kind = ScriptStep::FrameRate;
+            step.value = strtoul(arg, nullptr, 10);
+            ok = step.value > 0 && step.value <= 255;
+        }
+        else if (ok && strcmp(word, "expect") == 0)
+        {
+            step.kind = ScriptStep::Expect;
+            ok = false;
+            for (uint8_t i = 0; i < NUM_STATES; i++)
+            {
+                if (strcmp(arg, state_names[i]) == 0)
+                {
+                    step.value = i;
+                    ok = true;
+                }
+            }
+        }
+        else if (ok && strcmp(word, "restarts") == 0)
+        {
+            step.kind = ScriptStep::Restarts;
+            step.value = strtoul(arg, nullptr, 10);
+        }
+        else if (ok && strcmp(word, "latency") == 0)
+        {
+            step.kind = ScriptStep::Latency;
+            step.value = strtoul(arg2, nullptr, 10);
+            ok = parseButtons(arg, step.buttons) && step.buttons != 0 &&
+                 step.value > 0 && step.value <= MAX_LATENCY_FRAMES;
+        }
+        else if (ok && strcmp(word, "include") == 0)
+        {
+            depth++;
+            ok = loadScript(arg, script);
+            depth--;
+            continue;
+        }
+        else if (ok)
+        {
+            char *end;
+            step.value = strtoul(word, &end, 10);
+            ok = *end == '\0' && parseButtons(arg, step.buttons);
+        }
+
+        if (ok)
+            script.push_back(step);
+        else
+            fprintf(stderr, "%s:%u: can't read '%s'\n", path, line_number, word);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+bool saveScript(const char *path, const Script &script, const std::string &comment)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "%s: can't write\n", path);
+        return false;
+    }
+
+    fputs(comment.c_str(), file);
+
+    for (const ScriptStep &step : script)
+    {
+        switch (step.kind)
+        {
+        case ScriptStep::Frames:
+            fprintf(file, "%u %s\n", step.value, buttonText(step.buttons).c_str());
+            break;
+        case ScriptStep::Seed:
+            fprintf(file, "seed %u\n", step.value);
+            break;
+        case ScriptStep::FrameRate:
+            fprintf(file, "fps %u\n", step.value);
+            break;
+        case ScriptStep::Expect:
+            fprintf(file, "expect %s\n", state_names[step.value]);
+            break;
+        case ScriptStep::Latency:
+            fprintf(file, "latency %s %u\n", buttonText(step.buttons).c_str(), step.value);
+            break;
+        case ScriptStep::Restarts:
+            fprintf(file, "restarts %u\n", step.value);
+            break;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+void hostSetup()
+{
+    arduboy.begin();
+    arduboy.audio.on();
+
+    randomSeed(1);
+    game.begin();
+
+    arduboy.setFrameRate(FRAME_RATE);
+    game.setFrameRate(FRAME_RATE);
+
+    tunes.begin();
+    SERIAL_LINK_BEGIN();
+    arduboy.clear();
+}
+
+// the row stream_decode.py telemetry should write for this frame, without the times,
+// which don't move on the host, or whether it was a key frame
+static void captureStats()
+{
+    if (capture_stats == nullptr)
+        return;
+
+    GameStats stats = game.stats();
+    if (game.state() == GameState::GameOver && capture_state == GameState::InGame)
+        fprintf(capture_stats, ",death,,,,,,,%u\n", stats.score);
+    capture_state = game.state();
+
+    fprintf(capture_stats, "%u,,,,%u,%u,%u,%u,%u\n", capture_seq++, stats.squirrels, stats.balls,
+            stats.spawns, stats.barks, stats.score);
+}
+
+// named like the images stream_decode.py frames writes, one per frame end record
+static void captureFrame()
+{
+    if (capture_frames.empty())
+        return;
+
+    char name[32];
+    snprintf(name, sizeof(name), "/frame_%05u.pbm", captured_frames++);
+    writePbm((capture_frames + name).c_str());
+}
+
+void hostFrame(uint8_t buttons, RunResult &result)
+{
+    hostSetButtons(buttons);
+    power.waitForFrame(game.state());
+    arduboy.pollButtons();
+    power.update(game.state());
+
+    uint8_t state = (uint8_t)game.state();
+    host_ops = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TELEMETRY_FRAME_START();
+    game.update();
+    TELEMETRY_MARK_UPDATE();
+    game.draw();
+    TELEMETRY_MARK_DRAW();
+    FRAME_STREAM_SEND(game.state());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.frames++;
+    result.last_ops = host_ops;
+    result.shown_ms[state] += Arduboy2Base::frameMillis();
+    result.busy_ops[state] += host_ops;
+    result.seconds += elapsed.count();
+    if (host_ops > result.worst_ops)
+    {
+        result.worst_ops = host_ops;
+        result.worst_frame = result.frames;
+    }
+
+    result.stats = game.stats();
+    result.restarts = sounds.restartsAvoided();
+    result.particles = 0;
+    for (uint8_t i = 0; i < MAX_PARTICLES; i++)
+    {
+        if (particles.particles[i].life > 0)
+            result.particles++;
+    }
+
+    memcpy(last_frame, arduboy.getBuffer(), sizeof(last_frame));
+    arduboy.display(CLEAR_BUFFER);
+    TELEMETRY_SEND(game.state(), game.stats());
+    captureStats();
+    captureFrame();
+}
+
+// the hash of the frame drawn after holding the buttons for that many frames, leaving the game as it was
+static uint32_t hashAfter(uint8_t buttons, uint32_t frames)
+{
+    RunResult probe;
+    runForked([&](RunResult &run)
+    {
+        // the probe's frames never happened. dropping the files unflushed keeps them out
+        host_serial = nullptr;
+        capture_stats = nullptr;
+        capture_frames.clear();
+        for (uint32_t i = 0; i < frames; i++)
+            hostFrame(buttons, run);
+
+        run.hash = frameHash();
+    }, probe);
+
+    return probe.hash;
+}
+
+// frames from pressing the buttons to the first frame that differs from not pressing them,
+// 0 if none of the first MAX_LATENCY_FRAMES do
+static uint32_t measureLatency(uint8_t buttons)
+{
+    for (uint32_t frames = 1; frames <= MAX_LATENCY_FRAMES; frames++)
+    {
+        if (hashAfter(buttons, frames) != hashAfter(0, frames))
+            return frames;
+    }
+
+    return 0;
+}
+
+void runStep(const ScriptStep &step, RunResult &result)
+{
+    switch (step.kind)
+    {
+    case ScriptStep::Frames:
+        for (uint32_t i = 0; i < step.value; i++)
+            hostFrame(step.buttons, result);
+        break;
+    case ScriptStep::Seed:
+        randomSeed(step.value);
+        break;
+    case ScriptStep::FrameRate:
+        arduboy.setFrameRate(step.value);
+        game.setFrameRate(step.value);
+        break;
+    case ScriptStep::Expect:
+        if ((uint32_t)game.state() != step.value)
+        {
+            result.failed = true;
+            snprintf(result.error, sizeof(result.error), "expected %s after frame %u, got %s",
+                     state_names[step.value], result.frames, state_names[(uint8_t)game.state()]);
+        }
+        break;
+    case ScriptStep::Latency:
+    {
+        uint32_t latency = measureLatency(step.buttons);
+        if (latency != step.value)
+        {
+            result.failed = true;
+            snprintf(result.error, sizeof(result.error), "%s after frame %u changed the screen %u frames later, expected %u",
+                     buttonText(step.buttons).c_str(), result.frames, latency, step.value);
+        }
+        break;
+    }
+    case ScriptStep::Restarts:
+        if (sounds.restartsAvoided() != step.value)
+        {
+            result.failed = true;
+            snprintf(result.error, sizeof(result.error), "%u sound restarts avoided after frame %u, expected %u",
+                     sounds.restartsAvoided(), result.frames, step.value);
+        }
+        break;
+    }
+}
+
+// runs the steps up to the next frame of the running script. false at the end
+static bool nextScriptFrame()
+{
+    while (frames_left == 0)
+    {
+        if (next_step >= running_script->size() || running_result->failed)
+            return false;
+
+        const ScriptStep &step = (*running_script)[next_step++];
+        if (step.kind == ScriptStep::Frames)
+        {
+            frames_left = step.value;
+            held_buttons = step.buttons;
+        }
+        else
+        {
+            runStep(step, *running_result);
+        }
+    }
+
+    frames_left--;
+    return true;
+}
+
+// the game is waiting inside a frame. the script's frames go by as the time adds up
+static void waitScript(uint16_t ms, bool powered_down)
+{
+    uint8_t state = (uint8_t)game.state();
+    running_result->shown_ms[state] += ms;
+    if (powered_down)
+        running_result->asleep_ms[state] += ms;
+
+    waited_ms += ms;
+    while (waited_ms >= Arduboy2Base::frameMillis())
+    {
+        waited_ms -= Arduboy2Base::frameMillis();
+        if (!nextScriptFrame())
+            throw ScriptEnded();
+
+        hostSetButtons(held_buttons);
+    }
+}
+
+void runScript(const Script &script, RunResult &result)
+{
+    running_script = &script;
+    running_result = &result;
+    next_step = 0;
+    frames_left = 0;
+    waited_ms = 0;
+    host_wait = waitScript;
+
+    // a script that ends while the game waits just stops there
+    try
+    {
+        while (nextScriptFrame())
+            hostFrame(held_buttons, result);
+    }
+    catch (const ScriptEnded &)
+    {
+    }
+
+    host_wait = nullptr;
+    running_script = nullptr;
+    running_result = nullptr;
+    result.hash = frameHash();
+}
+
+bool runForked(const std::function<void(RunResult &)> &body, RunResult &result)
+{
+    memset(&result, 0, sizeof(result));
+
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        body(result);
+        bool sent = write(fds[1], &result, sizeof(result)) == (ssize_t)sizeof(result);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool received = pid > 0 && read(fds[0], &result, sizeof(result)) == (ssize_t)sizeof(result);
+    close(fds[0]);
+    if (pid > 0)
+        waitpid(pid, nullptr, 0);
+
+    return received;
+}
+
+bool startCapture(const std::string &prefix)
+{
+    host_serial = fopen((prefix + ".bin").c_str(), "wb");
+    capture_stats = fopen((prefix + "_stats.csv").c_str(), "w");
+    if (host_serial == nullptr || capture_stats == nullptr)
+    {
+        stopCapture();
+        return false;
+    }
+
+    fputs("seq,event,update_us,draw_us,squirrels,balls,spawns,barks,score\n", capture_stats);
+
+#if FRAME_STREAM_ENABLED
+    std::string frames = prefix + "_frames";
+    if (mkdir(frames.c_str(), 0777) != 0 && errno != EEXIST)
+    {
+        stopCapture();
+        return false;
+    }
+
+    capture_frames = frames;
+    captured_frames = 0;
+#endif
+    return true;
+}
+
+void stopCapture()
+{
+    if (host_serial != nullptr)
+        fclose(host_serial);
+    if (capture_stats != nullptr)
+        fclose(capture_stats);
+
+    host_serial = nullptr;
+    capture_stats = nullptr;
+    capture_frames.clear();
+}
+
+uint32_t frameHash()
+{
+    uint32_t hash = 2166136261UL;
+    for (uint16_t i = 0; i < sizeof(last_frame); i++)
+    {
+        hash ^= last_frame[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+// binary PBM, one bit per pixel in rows from the top left
+bool writePbm(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "P4\n%d %d\n", WIDTH, HEIGHT);
+    for (uint8_t y = 0; y < HEIGHT; y++)
+    {
+        for (uint8_t x = 0; x < WIDTH; x += 8)
+        {
+            uint8_t bits = 0;
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                if (last_frame[(y / 8) * WIDTH + x + i] & (1 << (y & 7)))
+                    bits |= 0x80 >> i;
+            }
+            fputc(bits, file);
+        }
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "Power.h"
+
+// one line of an input script:
+//   <frames> <buttons>   run that many frames holding the buttons, any of UDLRAB or - for none
+//   seed <n>             randomSeed(n)
+//   fps <n>              change the frame rate, like the adaptive frame rate does
+//   expect <state>       fail unless the game is in StartMenu, InGame, InHelp or GameOver
+//   restarts <n>         fail unless SoundQueue has skipped n sound restarts so far
+//   include <script>     the steps of another script, its path relative to the current directory
+//   latency <buttons> <n> fail unless holding the buttons changes the screen n frames after the
+//                        press, compared with holding nothing. the game carries on as if it hadn't run
+struct ScriptStep {
+    enum Kind : uint8_t
+    {
+        Frames,
+        Seed,
+        FrameRate,
+        Expect,
+        Latency,
+        Restarts,
+    };
+
+    Kind kind;
+    uint32_t value; // frames, seed, fps, GameState, latency in frames or restarts
+    uint8_t buttons;
+};
+
+typedef std::vector<ScriptStep> Script;
+
+extern Arduboy2 arduboy;
+extern Game game;
+extern PowerManager power;
+
+// true from the frame the dog is caught until Game Over, from Game.cpp
+extern bool lost;
+
+// what running a script did. a failed expect stops the script
+struct RunResult {
+    uint32_t frames;
+    uint32_t hash;        // of the last frame drawn
+    uint32_t last_ops;    // host_ops of the last frame's update() and draw()
+    uint32_t worst_ops;   // the most of any frame
+    uint32_t worst_frame; // the frame they happened in, counting from 1
+    GameStats stats;      // after the last frame
+    uint8_t particles;    // alive after the last frame
+    uint16_t restarts;    // SoundQueue::restartsAvoided() after the last frame
+    uint32_t shown_ms[NUM_STATES];  // time on each screen, awake or not, indexed by GameState
+    uint32_t asleep_ms[NUM_STATES]; // of that, powered down with the display off
+    uint32_t busy_ops[NUM_STATES];  // host_ops in update() and draw()
+    double seconds;       // spent in update() and draw()
+    bool failed;
+    char error[96];
+};
+
+bool loadScript(const char *path, Script &script);
+bool saveScript(const char *path, const Script &script, const std::string &comment);
+
+// the same steps as the sketch's setup() and loop(). once the power manager has turned
+// the display off, a script's frames go by a frame's worth of time each without being drawn
+void hostSetup();
+void hostFrame(uint8_t buttons, RunResult &result);
+
+void runStep(const ScriptStep &step, RunResult &result);
+void runScript(const Script &script, RunResult &result);
+
+// runs body in a forked process and passes back the result it fills in, so every run
+// starts from the game state of the caller and leaves it untouched. false if it crashed
+bool runForked(const std::function<void(RunResult &)> &body, RunResult &result);
+
+// while capturing, what the game writes to Serial goes to <prefix>.bin and every frame's
+// GameStats to <prefix>_stats.csv, as the rows stream_decode.py telemetry should decode
+// from it with the times and key frame column left empty. a FRAME_STREAM_ENABLED build
+// also saves every frame drawn as <prefix>_frames/frame_NNNNN.pbm, numbered like the
+// images stream_decode.py frames writes. false if a file can't be opened
+bool startCapture(const std::string &prefix);
+void stopCapture();
+
+// the last frame drawn, as FNV-1a of the buffer or as a PBM image
+uint32_t frameHash();
+bool writePbm(const char *path);
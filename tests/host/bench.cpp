@@ -0,0 +1,181 @@
+// measures a game frame with every squirrel and ball slot filled. spawning never fills
+// them in play, so before each frame every free slot gets a new entity somewhere on screen
+// and the dog is never caught
+//
+//   bench [--start SCRIPT] [--frames N] [--moves]
+//
+// prints the pool sizes it was built with (MAX_SQUIRRELS, MAX_BALLS) and the average and
+// worst ops and pc time of update() plus draw(). make bench builds it at 10, 32, 64 and 128.
+// --moves runs update() alone at 1 fps, 30 ticks a frame, with every squirrel making the
+// same kind of move, and prints each kind's ops and pc time per squirrel per tick next to Straight
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Harness.h"
+
+#define SCREEN_WIDTH 128
+#define STATUS_BAR_HEIGHT 8
+#define MOVES_REPEATS 5 // the fastest of these counts, the others had the pc busy with something else
+
+extern Entity squirrels[MAX_SQUIRRELS];
+extern Entity balls[MAX_BALLS];
+extern uint8_t frame_ticks;
+
+static const char *const move_names[NUM_SQUIRREL_MOVES] = {"Straight", "Weave", "Hop", "Dash"};
+
+struct MoveCost {
+    double ops;     // per squirrel per tick
+    double seconds;
+};
+
+static void fillEntity(Entity &entity, SquirrelMove move)
+{
+    entity.alive = true;
+    entity.x = pixelToFixed(random(0, SCREEN_WIDTH));
+    entity.y = random(STATUS_BAR_HEIGHT + 6, HEIGHT - 16 - 6);
+    entity.speed = random(FIXED_ONE, 2 * FIXED_ONE + 1);
+    entity.move = move;
+    entity.phase = 0;
+}
+
+// squirrels take each kind of movement in turn
+static void fillPools()
+{
+    for (uint8_t i = 0; i < MAX_SQUIRRELS; i++)
+    {
+        if (!squirrels[i].alive)
+            fillEntity(squirrels[i], (SquirrelMove)(i % NUM_SQUIRREL_MOVES));
+    }
+
+    for (uint8_t i = 0; i < MAX_BALLS; i++)
+    {
+        if (!balls[i].alive)
+            fillEntity(balls[i], SquirrelMove::Straight);
+    }
+
+    lost = false;
+}
+
+// every squirrel starts each frame at the right edge at 1 pixel a tick, so none leave the
+// screen before the frame's ticks move them
+static MoveCost measureMove(SquirrelMove move, uint32_t frames)
+{
+    MoveCost cost = {0, 0};
+    for (uint8_t repeat = 0; repeat < MOVES_REPEATS; repeat++)
+    {
+        uint64_t ops = 0;
+        uint64_t squirrel_ticks = 0;
+        std::chrono::duration<double> elapsed(0);
+
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            for (uint8_t j = 0; j < MAX_SQUIRRELS; j++)
+            {
+                fillEntity(squirrels[j], move);
+                squirrels[j].x = pixelToFixed(SCREEN_WIDTH);
+                squirrels[j].speed = FIXED_ONE;
+                squirrels[j].phase = j;
+            }
+            for (uint8_t j = 0; j < MAX_BALLS; j++)
+                balls[j].alive = false;
+            lost = false;
+
+            arduboy.nextFrame();
+            arduboy.pollButtons();
+
+            host_ops = 0;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            game.update();
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            ops += host_ops;
+            squirrel_ticks += (uint32_t)MAX_SQUIRRELS * frame_ticks;
+        }
+
+        cost.ops = (double)ops / squirrel_ticks;
+        if (repeat == 0 || elapsed.count() / squirrel_ticks < cost.seconds)
+            cost.seconds = elapsed.count() / squirrel_ticks;
+    }
+
+    return cost;
+}
+
+static void benchMoves(uint32_t frames)
+{
+    arduboy.setFrameRate(1);
+    game.setFrameRate(1);
+
+    MoveCost straight = measureMove(SquirrelMove::Straight, frames);
+    printf("%-8s %5.2f ops %6.2f ns a squirrel a tick, with the rest of update()\n",
+           move_names[0], straight.ops, straight.seconds * 1e9);
+
+    for (uint8_t i = 1; i < NUM_SQUIRREL_MOVES; i++)
+    {
+        MoveCost cost = measureMove((SquirrelMove)i, frames);
+        printf("%-8s %+5.2f ops %+6.2f ns a squirrel a tick against Straight\n",
+               move_names[i], cost.ops - straight.ops, (cost.seconds - straight.seconds) * 1e9);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *start_path = "fuzz_start.txt";
+    uint32_t frames = 3000;
+    bool moves = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if (has_value && strcmp(argv[i], "--start") == 0)
+            start_path = argv[++i];
+        else if (has_value && strcmp(argv[i], "--frames") == 0)
+            frames = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--moves") == 0)
+            moves = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--start SCRIPT] [--frames N] [--moves]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Script start;
+    if (!loadScript(start_path, start) || frames == 0)
+        return 1;
+
+    RunResult result;
+    memset(&result, 0, sizeof(result));
+    hostSetup();
+    runScript(start, result);
+    if (result.failed || game.state() != GameState::InGame)
+    {
+        fprintf(stderr, "%s: doesn't leave the game in InGame\n", start_path);
+        return 1;
+    }
+
+    if (moves)
+    {
+        benchMoves(frames);
+        return 0;
+    }
+
+    memset(&result, 0, sizeof(result));
+    uint64_t total_ops = 0;
+    uint32_t min_alive = MAX_SQUIRRELS + MAX_BALLS;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        fillPools();
+        hostFrame(0, result);
+        total_ops += result.last_ops;
+
+        // what was drawn, after this frame's update took out whatever left the screen
+        min_alive = min(min_alive, (uint32_t)(result.stats.squirrels + result.stats.balls));
+    }
+
+    printf("%3u squirrels %3u balls: %6llu ops a frame, worst %6u, %4u or more alive when drawn, %7.2f us a frame on this pc\n",
+           MAX_SQUIRRELS, MAX_BALLS, (unsigned long long)(total_ops / frames), result.worst_ops, min_alive,
+           result.seconds * 1e6 / frames);
+    return 0;
+}
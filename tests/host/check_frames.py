@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Check the frames stream_decode.py frames rebuilt from a capture against the frames the harness drew.
+
+usage: check_frames.py CAPTURE DECODED_DIR DRAWN_DIR
+
+Both directories hold frame_NNNNN.pbm, one per frame. A frame whose frame end
+record says every page had been sent has to match the drawn one exactly. The
+others are still catching up with the screen and only get counted. The harness
+draws lit pixels black and stream_decode.py draws them white, so the pixels are
+compared, not the files.
+"""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools"))
+from stream_decode import FRAME_COMPLETE, FRAME_END, records  # noqa: E402
+
+
+def lit_pixels(directory, frame, lit_is_black):
+    path = os.path.join(directory, f"frame_{frame:05d}.pbm")
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        header = f.readline() + f.readline()
+        raster = f.read()
+    return header, raster if lit_is_black else bytes(255 - byte for byte in raster)
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__.splitlines()[2], file=sys.stderr)
+        return 2
+    capture, decoded, drawn = sys.argv[1:]
+
+    with open(capture, "rb") as stream:
+        flags = [payload[1] for kind, payload in records(stream) if kind == FRAME_END]
+
+    drawn_frames = len([name for name in os.listdir(drawn) if name.endswith(".pbm")])
+    if len(flags) != drawn_frames:
+        print(f"{len(flags)} frames streamed, {drawn_frames} drawn", file=sys.stderr)
+        return 1
+
+    complete = 0
+    differ = []
+    for frame, flag in enumerate(flags):
+        if not flag & FRAME_COMPLETE:
+            continue
+        complete += 1
+        if lit_pixels(decoded, frame, False) != lit_pixels(drawn, frame, True):
+            differ.append(frame)
+
+    print(f"{complete} of {len(flags)} frames complete, {len(differ)} differ from what was drawn")
+    if differ:
+        print("first differs: frame_%05d.pbm" % differ[0], file=sys.stderr)
+    return 1 if differ or complete == 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,140 @@
+// plays on from a start script with a bot until the score is high enough that squirrels
+// come often and fast, and saves the game so far as a script. it's the late game start
+// the fuzzer searches from
+//
+//   climb [--start SCRIPT] [--score N] [--out SCRIPT]
+//
+// every few frames the bot tries each way of holding the d-pad, with and without a bark,
+// for a second in a forked process, and plays whichever stays alive longest and scores most
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Harness.h"
+
+#define DECIDE_FRAMES 4
+#define LOOKAHEAD_FRAMES 30
+#define MAX_FRAMES 60000
+
+static const uint8_t directions[] = {
+    0, UP_BUTTON, DOWN_BUTTON, LEFT_BUTTON, RIGHT_BUTTON,
+    UP_BUTTON | LEFT_BUTTON, UP_BUTTON | RIGHT_BUTTON, DOWN_BUTTON | LEFT_BUTTON, DOWN_BUTTON | RIGHT_BUTTON,
+};
+
+// A only goes down on the first frame, so it's a fresh press every time it's picked
+static void playMove(uint8_t buttons, uint32_t frames, RunResult &result, Script *played)
+{
+    for (uint32_t i = 0; i < frames && !lost; i++)
+    {
+        uint8_t held = i == 0 ? buttons : buttons & ~A_BUTTON;
+        hostFrame(held, result);
+
+        if (played == nullptr)
+            continue;
+
+        if (!played->empty() && played->back().buttons == held)
+            played->back().value++;
+        else
+            played->push_back({ScriptStep::Frames, 1, held});
+    }
+}
+
+// frames survived first, then score. a move only replaces the one before it if it's
+// strictly better, so the bot doesn't twitch between equally good moves
+static uint8_t chooseMove(uint8_t previous)
+{
+    uint8_t best = previous;
+    uint32_t best_frames = 0;
+    uint16_t best_score = 0;
+
+    for (uint8_t i = 0; i <= sizeof(directions) * 2; i++)
+    {
+        uint8_t buttons = i == 0 ? previous : directions[(i - 1) % sizeof(directions)];
+        if (i > sizeof(directions))
+            buttons |= A_BUTTON;
+
+        RunResult result;
+        if (!runForked([&](RunResult &run) { playMove(buttons, LOOKAHEAD_FRAMES, run, nullptr); }, result))
+            continue;
+
+        if (result.frames > best_frames || (result.frames == best_frames && result.stats.score > best_score))
+        {
+            best = buttons;
+            best_frames = result.frames;
+            best_score = result.stats.score;
+        }
+    }
+
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const char *start_path = "fuzz_start.txt";
+    const char *out_path = "scenes/late_game.txt";
+    uint16_t target = 300;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if (has_value && strcmp(argv[i], "--start") == 0)
+            start_path = argv[++i];
+        else if (has_value && strcmp(argv[i], "--out") == 0)
+            out_path = argv[++i];
+        else if (has_value && strcmp(argv[i], "--score") == 0)
+            target = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--start SCRIPT] [--score N] [--out SCRIPT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Script start;
+    if (!loadScript(start_path, start))
+        return 1;
+
+    RunResult result;
+    memset(&result, 0, sizeof(result));
+    hostSetup();
+    runScript(start, result);
+    if (result.failed || game.state() != GameState::InGame)
+    {
+        fprintf(stderr, "%s: doesn't leave the game in InGame\n", start_path);
+        return 1;
+    }
+
+    Script played;
+    uint8_t buttons = 0;
+    while (game.stats().score < target && result.frames < MAX_FRAMES)
+    {
+        buttons = chooseMove(buttons & ~A_BUTTON);
+        playMove(buttons, DECIDE_FRAMES, result, &played);
+
+        if (lost)
+        {
+            fprintf(stderr, "caught at score %u after %u frames\n", game.stats().score, result.frames);
+            return 1;
+        }
+    }
+
+    if (game.stats().score < target)
+    {
+        fprintf(stderr, "only got to score %u in %u frames\n", game.stats().score, result.frames);
+        return 1;
+    }
+
+    played.push_back({ScriptStep::Expect, (uint32_t)GameState::InGame, 0});
+
+    char comment[256];
+    snprintf(comment, sizeof(comment),
+             "# played by climb --score %u from %s: score %u after %u frames\n"
+             "include %s\n",
+             target, start_path, game.stats().score, result.frames, start_path);
+
+    if (!saveScript(out_path, played, comment))
+        return 1;
+
+    printf("%s: score %u after %u frames\n", out_path, game.stats().score, result.frames);
+    return 0;
+}
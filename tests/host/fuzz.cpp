@@ -0,0 +1,294 @@
+// searches input sequences and random seeds for the frame whose update() plus draw() costs the most
+//
+//   fuzz [--start SCRIPT] [--runs N] [--frames N] [--seed N] [--keep N] [--min-particles N] [--out DIR] [--name NAME]
+//
+// the start script is played once and every candidate runs in a process forked from
+// there, so they all start from the same game state. the default start is the late game
+// climb.cpp plays, where squirrels come often and fast enough to fill the pools. a
+// candidate is a seed and up to --frames frames of input, or until the dog is caught.
+// half the time it's new, otherwise a changed copy of one of the worst so far. cost is
+// host_ops (see stubs/Arduboy2.h), which is the same every time a candidate is replayed.
+// the --keep worst, each from a different new candidate and its copies, are saved to DIR
+// as scripts that include the start script and replay the candidate up to its worst frame,
+// named NAME_1.txt and on. the costliest frames have every squirrel alive and no bursts,
+// barks would cost them squirrels, so --min-particles only counts frames with at least that
+// many particles alive, to find the worst frame with bursts on screen as well
+
+#include <random>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Harness.h"
+
+struct Candidate {
+    uint32_t lineage; // the run of the new candidate this one was copied from
+    uint32_t seed;
+    Script input; // Frames steps only
+    RunResult result; // frames, worst ops and worst frame. stats and particles are the worst frame's
+};
+
+static std::mt19937 fuzz_rng;
+
+static uint32_t pick(uint32_t n)
+{
+    return fuzz_rng() % n;
+}
+
+// at most one vertical and one horizontal direction, and A now and then to bark.
+// B is left out, the help screen costs next to nothing
+static uint8_t randomButtons()
+{
+    static const uint8_t vertical[] = {0, UP_BUTTON, DOWN_BUTTON};
+    static const uint8_t horizontal[] = {0, LEFT_BUTTON, RIGHT_BUTTON};
+
+    uint8_t buttons = vertical[pick(3)] | horizontal[pick(3)];
+    if (pick(4) == 0)
+        buttons |= A_BUTTON;
+
+    return buttons;
+}
+
+static ScriptStep randomStep()
+{
+    ScriptStep step = {ScriptStep::Frames, 1 + pick(20), randomButtons()};
+    return step;
+}
+
+// cuts the input to the first frames, or pads it with random steps up to them
+static void fitInput(Script &input, uint32_t frames)
+{
+    Script fitted;
+    uint32_t total = 0;
+    for (const ScriptStep &step : input)
+    {
+        if (total >= frames)
+            break;
+
+        fitted.push_back(step);
+        fitted.back().value = min(step.value, frames - total);
+        total += fitted.back().value;
+    }
+
+    while (total < frames)
+    {
+        fitted.push_back(randomStep());
+        fitted.back().value = min(fitted.back().value, frames - total);
+        total += fitted.back().value;
+    }
+
+    input.swap(fitted);
+}
+
+static void mutate(Candidate &candidate, uint32_t frames)
+{
+    Script &input = candidate.input;
+    uint32_t i = pick(input.size());
+
+    switch (pick(4))
+    {
+    case 0:
+        candidate.seed = fuzz_rng();
+        break;
+    case 1:
+        input[i].buttons = randomButtons();
+        break;
+    case 2:
+        input[i].value = 1 + pick(20);
+        break;
+    case 3:
+        // keep what led up to the worst frame, try something else after it
+        input.resize(i);
+        break;
+    }
+
+    fitInput(input, frames);
+}
+
+static bool evaluate(Candidate &candidate, uint8_t min_particles)
+{
+    return runForked([&](RunResult &result)
+    {
+        // only frames drawn in game count. the run ends when the dog is caught, the game over
+        // screen and the menus cost the same every time and aren't what's being looked for
+        uint32_t worst_ops = 0;
+        uint32_t worst_frame = 0;
+        GameStats worst_stats = game.stats();
+        uint8_t worst_particles = 0;
+
+        randomSeed(candidate.seed);
+        for (const ScriptStep &step : candidate.input)
+        {
+            for (uint32_t i = 0; i < step.value && !lost; i++)
+            {
+                hostFrame(step.buttons, result);
+                if (!lost && result.particles >= min_particles && result.last_ops > worst_ops)
+                {
+                    worst_ops = result.last_ops;
+                    worst_frame = result.frames;
+                    worst_stats = result.stats;
+                    worst_particles = result.particles;
+                }
+            }
+        }
+
+        result.worst_ops = worst_ops;
+        result.worst_frame = worst_frame;
+        result.stats = worst_stats;
+        result.particles = worst_particles;
+    }, candidate.result);
+}
+
+// keeps the worst candidates, worst first, at most one per lineage so they don't all
+// end up as copies of the same run
+static void keepWorst(std::vector<Candidate> &worst, const Candidate &candidate, uint32_t keep)
+{
+    for (size_t i = 0; i < worst.size(); i++)
+    {
+        if (worst[i].lineage != candidate.lineage)
+            continue;
+
+        if (worst[i].result.worst_ops >= candidate.result.worst_ops)
+            return;
+
+        worst.erase(worst.begin() + i);
+        break;
+    }
+
+    size_t i = 0;
+    while (i < worst.size() && worst[i].result.worst_ops >= candidate.result.worst_ops)
+        i++;
+
+    if (i >= keep)
+        return;
+
+    worst.insert(worst.begin() + i, candidate);
+    if (worst.size() > keep)
+        worst.pop_back();
+}
+
+static bool saveWorst(const char *path, const char *start_path, const Candidate &candidate, uint32_t fuzz_seed)
+{
+    Script script;
+    script.push_back({ScriptStep::Seed, candidate.seed, 0});
+
+    Script input = candidate.input;
+    fitInput(input, candidate.result.worst_frame);
+    script.insert(script.end(), input.begin(), input.end());
+    script.push_back({ScriptStep::Expect, (uint32_t)GameState::InGame, 0});
+
+    const RunResult &result = candidate.result;
+    char comment[512];
+    snprintf(comment, sizeof(comment),
+             "# found by fuzz --seed %u from %s\n"
+             "# the last frame's update() and draw() cost %u ops, the most of any game frame it found,\n"
+             "# with %u of %u squirrels, %u of %u balls and %u of %u particles alive at score %u\n"
+             "include %s\n",
+             fuzz_seed, start_path, result.worst_ops,
+             result.stats.squirrels, MAX_SQUIRRELS, result.stats.balls, MAX_BALLS,
+             result.particles, MAX_PARTICLES, result.stats.score, start_path);
+
+    return saveScript(path, script, comment);
+}
+
+int main(int argc, char **argv)
+{
+    const char *start_path = "scenes/late_game.txt";
+    const char *out_dir = "worst";
+    const char *name = "worst";
+    uint32_t runs = 20000;
+    uint32_t frames = 900;
+    uint32_t fuzz_seed = 1;
+    uint32_t keep = 3;
+    uint8_t min_particles = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if (has_value && strcmp(argv[i], "--start") == 0)
+            start_path = argv[++i];
+        else if (has_value && strcmp(argv[i], "--out") == 0)
+            out_dir = argv[++i];
+        else if (has_value && strcmp(argv[i], "--name") == 0)
+            name = argv[++i];
+        else if (has_value && strcmp(argv[i], "--min-particles") == 0)
+            min_particles = strtoul(argv[++i], nullptr, 10);
+        else if (has_value && strcmp(argv[i], "--runs") == 0)
+            runs = strtoul(argv[++i], nullptr, 10);
+        else if (has_value && strcmp(argv[i], "--frames") == 0)
+            frames = strtoul(argv[++i], nullptr, 10);
+        else if (has_value && strcmp(argv[i], "--seed") == 0)
+            fuzz_seed = strtoul(argv[++i], nullptr, 10);
+        else if (has_value && strcmp(argv[i], "--keep") == 0)
+            keep = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--start SCRIPT] [--runs N] [--frames N] [--seed N] [--keep N] "
+                            "[--min-particles N] [--out DIR] [--name NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (frames == 0 || keep == 0)
+        return 2;
+
+    Script start;
+    if (!loadScript(start_path, start))
+        return 1;
+
+    // the snapshot every candidate starts from
+    RunResult start_result;
+    memset(&start_result, 0, sizeof(start_result));
+    hostSetup();
+    runScript(start, start_result);
+    if (start_result.failed || game.state() != GameState::InGame)
+    {
+        fprintf(stderr, "%s: %s\n", start_path, start_result.failed ? start_result.error : "doesn't end in game");
+        return 1;
+    }
+
+    fuzz_rng.seed(fuzz_seed);
+    std::vector<Candidate> worst;
+
+    for (uint32_t run = 1; run <= runs; run++)
+    {
+        Candidate candidate;
+        if (worst.empty() || pick(2) == 0)
+        {
+            candidate.lineage = run;
+            candidate.seed = fuzz_rng();
+            fitInput(candidate.input, frames);
+        }
+        else
+        {
+            candidate = worst[pick(worst.size())];
+            mutate(candidate, frames);
+        }
+
+        if (!evaluate(candidate, min_particles))
+        {
+            fprintf(stderr, "run %u crashed\n", run);
+            return 1;
+        }
+
+        if (worst.empty() || candidate.result.worst_ops > worst[0].result.worst_ops)
+            printf("run %5u: %5u ops in frame %u\n", run, candidate.result.worst_ops, candidate.result.worst_frame);
+
+        keepWorst(worst, candidate, keep);
+    }
+
+    for (size_t i = 0; i < worst.size(); i++)
+    {
+        std::string path = std::string(out_dir) + "/" + name + "_" + std::to_string(i + 1) + ".txt";
+        if (!saveWorst(path.c_str(), start_path, worst[i], fuzz_seed))
+            return 1;
+
+        const RunResult &result = worst[i].result;
+        printf("%s: %u ops in frame %u, %u squirrels, %u balls, %u particles\n", path.c_str(),
+               result.worst_ops, result.worst_frame, result.stats.squirrels, result.stats.balls, result.particles);
+    }
+
+    printf("make update-goldens records their last frames, then make test replays them\n");
+    return 0;
+}
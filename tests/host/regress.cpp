@@ -0,0 +1,212 @@
+// runs input scripts through the game and compares the last frame of each with goldens.txt.
+// each line shows the last frame's ops, how many squirrels, balls and particles were alive
+// and how many sound restarts SoundQueue had skipped
+//
+//   regress [--update] [--goldens FILE] [--pbm DIR] [--power] [--capture DIR] SCRIPT...
+//
+// --update records the hashes instead of checking them. --pbm saves each script's
+// last frame as DIR/<name>.pbm, to look at what a golden is of. --power shows how the
+// time on each screen was split between update() and draw(), idling between frames
+// and being powered down by PowerManager. --capture saves what a TELEMETRY_ENABLED build
+// writes to Serial as DIR/<name>.bin, with the stats it should decode to next to it,
+// see startCapture()
+
+#include <map>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Harness.h"
+
+// a guess at what an op costs on the Arduboy, 32 cycles, for the --power split only.
+// PROFILER_ENABLED measures the real thing
+#define US_PER_OP 2
+
+typedef std::map<std::string, uint32_t> Goldens;
+
+static const char *const state_names[NUM_STATES] = {"StartMenu", "InGame", "InHelp", "GameOver"};
+
+static std::string scriptName(const char *path)
+{
+    std::string name = path;
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string::npos)
+        name = name.substr(slash + 1);
+
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos)
+        name = name.substr(0, dot);
+
+    return name;
+}
+
+static void loadGoldens(const char *path, Goldens &goldens)
+{
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+        return;
+
+    char line[128];
+    char name[96];
+    unsigned hash;
+    while (fgets(line, sizeof(line), file))
+    {
+        if (line[0] != '#' && sscanf(line, "%95s %x", name, &hash) == 2)
+            goldens[name] = hash;
+    }
+
+    fclose(file);
+}
+
+static bool saveGoldens(const char *path, const Goldens &goldens)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    fputs("# script, FNV-1a of its last frame. make update-goldens rewrites this\n", file);
+    for (const auto &golden : goldens)
+        fprintf(file, "%s %08x\n", golden.first.c_str(), golden.second);
+
+    fclose(file);
+    return true;
+}
+
+// every script runs in its own process, so each one starts from the game's power on state
+static bool runIsolated(const char *path, const char *pbm_dir, const char *capture_dir, RunResult &result)
+{
+    return runForked([&](RunResult &run)
+    {
+        Script script;
+        if (!loadScript(path, script))
+        {
+            run.failed = true;
+            snprintf(run.error, sizeof(run.error), "bad script");
+        }
+        else if (capture_dir != nullptr && !startCapture(std::string(capture_dir) + "/" + scriptName(path)))
+        {
+            run.failed = true;
+            snprintf(run.error, sizeof(run.error), "can't write the capture");
+        }
+        else
+        {
+            hostSetup();
+            runScript(script, run);
+            stopCapture();
+        }
+
+        if (pbm_dir != nullptr)
+            writePbm((std::string(pbm_dir) + "/" + scriptName(path) + ".pbm").c_str());
+    }, result);
+}
+
+static void printPower(const RunResult &result)
+{
+    for (uint8_t i = 0; i < NUM_STATES; i++)
+    {
+        if (result.shown_ms[i] == 0)
+            continue;
+
+        double shown_us = result.shown_ms[i] * 1000.0;
+        double busy = min(result.busy_ops[i] * (double)US_PER_OP / shown_us, 1.0);
+        double asleep = result.asleep_ms[i] * 1000.0 / shown_us;
+        printf("    %-10s %8.1f s: %5.1f%% busy, %5.1f%% idle, %5.1f%% powered down\n", state_names[i],
+               result.shown_ms[i] / 1000.0, busy * 100, (1 - busy - asleep) * 100, asleep * 100);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *goldens_path = "goldens.txt";
+    const char *pbm_dir = nullptr;
+    const char *capture_dir = nullptr;
+    bool update = false;
+    bool power_split = false;
+    int first_script = 1;
+
+    for (; first_script < argc && argv[first_script][0] == '-'; first_script++)
+    {
+        if (strcmp(argv[first_script], "--update") == 0)
+            update = true;
+        else if (strcmp(argv[first_script], "--goldens") == 0 && first_script + 1 < argc)
+            goldens_path = argv[++first_script];
+        else if (strcmp(argv[first_script], "--pbm") == 0 && first_script + 1 < argc)
+            pbm_dir = argv[++first_script];
+        else if (strcmp(argv[first_script], "--capture") == 0 && first_script + 1 < argc)
+            capture_dir = argv[++first_script];
+        else if (strcmp(argv[first_script], "--power") == 0)
+            power_split = true;
+        else
+            break;
+    }
+
+    if (first_script >= argc)
+    {
+        fprintf(stderr, "usage: %s [--update] [--goldens FILE] [--pbm DIR] [--power] [--capture DIR] SCRIPT...\n", argv[0]);
+        return 2;
+    }
+
+    Goldens goldens;
+    loadGoldens(goldens_path, goldens);
+
+    unsigned failures = 0;
+    uint32_t total_frames = 0;
+    double total_seconds = 0;
+
+    for (int i = first_script; i < argc; i++)
+    {
+        std::string name = scriptName(argv[i]);
+        RunResult result;
+
+        if (!runIsolated(argv[i], pbm_dir, capture_dir, result))
+        {
+            result.failed = true;
+            snprintf(result.error, sizeof(result.error), "the run crashed");
+        }
+
+        total_frames += result.frames;
+        total_seconds += result.seconds;
+
+        const char *status = "ok";
+        if (result.failed)
+        {
+            status = result.error;
+        }
+        else if (update)
+        {
+            goldens[name] = result.hash;
+            status = "updated";
+        }
+        else if (goldens.count(name) == 0)
+        {
+            status = "no golden";
+            result.failed = true;
+        }
+        else if (goldens[name] != result.hash)
+        {
+            status = "hash differs from golden";
+            result.failed = true;
+        }
+
+        if (result.failed)
+            failures++;
+
+        printf("%-24s %08x %6u frames, last frame %5u ops %2u/%u/%u alive, %3u restarts avoided  %s\n",
+               name.c_str(), result.hash, result.frames, result.last_ops,
+               result.stats.squirrels, result.stats.balls, result.particles, result.restarts, status);
+        if (power_split)
+            printPower(result);
+    }
+
+    if (total_seconds > 0)
+        printf("update+draw: %u frames in %.1f ms, %.0f frames/s\n",
+               total_frames, total_seconds * 1000, total_frames / total_seconds);
+
+    if (update && failures == 0 && !saveGoldens(goldens_path, goldens))
+    {
+        fprintf(stderr, "%s: can't write\n", goldens_path);
+        return 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+#include <Arduboy2.h>
+
+uint8_t Arduboy2Base::sBuffer[WIDTH * HEIGHT / 8];
+
+static uint8_t host_buttons = 0;
+static uint8_t each_frame_millis = 16;
+static bool audio_enabled = false;
+
+void hostSetButtons(uint8_t buttons)
+{
+    host_buttons = buttons;
+}
+
+void Arduboy2Audio::on()
+{
+    audio_enabled = true;
+}
+
+void Arduboy2Audio::off()
+{
+    audio_enabled = false;
+}
+
+bool Arduboy2Audio::enabled()
+{
+    return audio_enabled;
+}
+
+void Arduboy2Base::begin()
+{
+    clear();
+}
+
+void Arduboy2Base::setFrameRate(uint8_t rate)
+{
+    each_frame_millis = 1000 / rate;
+}
+
+uint8_t Arduboy2Base::frameMillis()
+{
+    return each_frame_millis;
+}
+
+// there is never any time to wait, the frame starts straight away
+bool Arduboy2Base::nextFrame()
+{
+    host_millis += each_frame_millis;
+    return true;
+}
+
+uint8_t Arduboy2Base::buttonsState()
+{
+    return host_buttons;
+}
+
+void Arduboy2Base::pollButtons()
+{
+    _previous_buttons = _current_buttons;
+    _current_buttons = buttonsState();
+}
+
+// 50 ms at a time, like the library. with no script to let go of the buttons it gives up
+void Arduboy2Base::waitNoButtons()
+{
+    while (buttonsState() && host_wait != nullptr)
+    {
+        host_millis += 50;
+        host_wait(50, false);
+    }
+}
+
+bool Arduboy2Base::pressed(uint8_t buttons)
+{
+    return (buttonsState() & buttons) == buttons;
+}
+
+bool Arduboy2Base::anyPressed(uint8_t buttons)
+{
+    return (buttonsState() & buttons) != 0;
+}
+
+bool Arduboy2Base::justPressed(uint8_t button)
+{
+    return !(_previous_buttons & button) && (_current_buttons & button);
+}
+
+void Arduboy2Base::clear()
+{
+    memset(sBuffer, 0, sizeof(sBuffer));
+}
+
+void Arduboy2Base::display()
+{
+}
+
+void Arduboy2Base::display(bool clear)
+{
+    if (clear)
+        this->clear();
+}
+
+uint8_t *Arduboy2Base::getBuffer()
+{
+    return sBuffer;
+}
+
+void Arduboy2Base::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+        return;
+
+    host_ops++;
+    uint8_t bit = 1 << (y & 7);
+    if (color)
+        sBuffer[(y / 8) * WIDTH + x] |= bit;
+    else
+        sBuffer[(y / 8) * WIDTH + x] &= ~bit;
+}
+
+void Arduboy2Base::drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color)
+{
+    for (uint8_t i = 0; i < w; i++)
+        drawPixel(x + i, y, color);
+}
+
+void Arduboy2Base::drawFastVLine(int16_t x, int16_t y, uint8_t h, uint8_t color)
+{
+    for (uint8_t i = 0; i < h; i++)
+        drawPixel(x, y + i, color);
+}
+
+void Arduboy2Base::fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+    for (uint8_t i = 0; i < w; i++)
+        drawFastVLine(x + i, y, h, color);
+}
+
+// the same midpoint circles as Arduboy2
+void Arduboy2Base::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    drawPixel(x0, y0 + r, color);
+    drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color);
+    drawPixel(x0 - r, y0, color);
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        drawPixel(x0 + x, y0 + y, color);
+        drawPixel(x0 - x, y0 + y, color);
+        drawPixel(x0 + x, y0 - y, color);
+        drawPixel(x0 - x, y0 - y, color);
+        drawPixel(x0 + y, y0 + x, color);
+        drawPixel(x0 - y, y0 + x, color);
+        drawPixel(x0 + y, y0 - x, color);
+        drawPixel(x0 - y, y0 - x, color);
+    }
+}
+
+void Arduboy2Base::fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        drawFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+        drawFastVLine(x0 + y, y0 - x, 2 * x + 1, color);
+        drawFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+        drawFastVLine(x0 - y, y0 - x, 2 * x + 1, color);
+    }
+}
+
+bool Arduboy2Base::collide(Rect rect1, Rect rect2)
+{
+    host_ops++;
+    return !(rect2.x >= rect1.x + rect1.width ||
+             rect2.x + rect2.width <= rect1.x ||
+             rect2.y >= rect1.y + rect1.height ||
+             rect2.y + rect2.height <= rect1.y);
+}
+
+size_t Arduboy2::write(uint8_t c)
+{
+    if (c == '\n')
+    {
+        _cursor_y += 8 * _text_size;
+        _cursor_x = 0;
+    }
+    else if (c != '\r')
+    {
+        drawChar(_cursor_x, _cursor_y, c, _text_size);
+        _cursor_x += 6 * _text_size;
+    }
+
+    return 1;
+}
+
+void Arduboy2::setCursor(int16_t x, int16_t y)
+{
+    _cursor_x = x;
+    _cursor_y = y;
+}
+
+// a 6x8 cell like Arduboy2's, background included. the library's font isn't here,
+// so each character gets a made up pattern. text that changes still changes the frame
+void Arduboy2::drawChar(int16_t x, int16_t y, unsigned char c, uint8_t size)
+{
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        uint8_t line = (i == 5 || c == ' ') ? 0 : (uint8_t)((c * 0x9D + i * 0x3B) ^ (c >> i)) & 0x7F;
+
+        for (uint8_t j = 0; j < 8; j++)
+        {
+            fillRect(x + i * size, y + j * size, size, size, line & 1);
+            line >>= 1;
+        }
+    }
+}
+
+// sprite frames are stored a page (8 rows) at a time, the same as the screen. like the
+// library, every byte of the sprite is read whether or not any of its pixels are lit
+static void drawSprite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame, bool overwrite)
+{
+    uint8_t w = pgm_read_byte(bitmap);
+    uint8_t h = pgm_read_byte(bitmap + 1);
+    uint8_t pages = (h + 7) / 8;
+    const uint8_t *data = bitmap + 2 + frame * w * pages;
+
+    for (uint8_t page = 0; page < pages; page++)
+    {
+        for (uint8_t col = 0; col < w; col++)
+        {
+            uint8_t bits = pgm_read_byte(data + page * w + col);
+            for (uint8_t row = page * 8; row < h && row < page * 8 + 8; row++)
+            {
+                uint8_t bit = (bits >> (row & 7)) & 1;
+                if (bit || overwrite)
+                    Arduboy2Base::drawPixel(x + col, y + row, bit);
+            }
+        }
+    }
+}
+
+void Sprites::drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+    drawSprite(x, y, bitmap, frame, true);
+}
+
+void Sprites::drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame)
+{
+    drawSprite(x, y, bitmap, frame, false);
+}
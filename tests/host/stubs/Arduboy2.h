@@ -0,0 +1,128 @@
+#pragma once
+
+// the parts of Arduboy2 the game uses, drawing into a real frame buffer.
+// buttons come from hostSetButtons() and the clock moves a whole frame each nextFrame()
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+#define WIDTH 128
+#define HEIGHT 64
+
+#define BLACK 0
+#define WHITE 1
+
+#define LEFT_BUTTON 32
+#define RIGHT_BUTTON 64
+#define UP_BUTTON 128
+#define DOWN_BUTTON 16
+#define A_BUTTON 8
+#define B_BUTTON 4
+
+#define PIN_SPEAKER_1 5
+#define PIN_SPEAKER_2 13
+
+#define CLEAR_BUFFER true
+
+// host_ops, the rough stand-in for cpu time, goes up by one for every pixel written,
+// sprite byte or flash byte read, collision test, random number and sound call, and by
+// whatever the game's update loops count with COUNT_WORK(): one per entity moved or
+// spawn slot checked, per particle moved or drawn. on the Arduboy COUNT_WORK() is nothing
+#define COUNT_WORK(units) (host_ops += (units))
+
+void hostSetButtons(uint8_t buttons);
+
+struct Rect {
+    int16_t x;
+    int16_t y;
+    uint8_t width;
+    uint8_t height;
+
+    Rect() {}
+    Rect(int16_t x, int16_t y, uint8_t width, uint8_t height)
+        : x(x), y(y), width(width), height(height) {}
+};
+
+class Arduboy2Audio {
+    public:
+        static void begin() {}
+        static void on();
+        static void off();
+        static bool enabled();
+};
+
+class BeepPin1 {
+    public:
+        static void begin() {}
+        static void tone(uint16_t count) { (void)count; host_ops++; }
+        static void noTone() { host_ops++; }
+};
+
+class Arduboy2Base {
+    public:
+        Arduboy2Audio audio;
+
+        void begin();
+        void boot() {}
+        void flashlight() {}
+        void systemButtons() {}
+        void initRandomSeed() {}
+
+        void setFrameRate(uint8_t rate);
+        static uint8_t frameMillis(); // whole ms per frame, from setFrameRate()
+        bool nextFrame();
+        int cpuLoad() { return 0; }
+        void idle() {}
+        void displayOff() {}
+        void displayOn() {}
+
+        uint8_t buttonsState();
+        void pollButtons();
+        void waitNoButtons();
+        bool pressed(uint8_t buttons);
+        bool anyPressed(uint8_t buttons);
+        bool justPressed(uint8_t button);
+
+        void clear();
+        void display();
+        void display(bool clear);
+        uint8_t *getBuffer();
+
+        static void drawPixel(int16_t x, int16_t y, uint8_t color = WHITE);
+        void drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color = WHITE);
+        void drawFastVLine(int16_t x, int16_t y, uint8_t h, uint8_t color = WHITE);
+        void fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color = WHITE);
+        void drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
+        void fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
+
+        static bool collide(Rect rect1, Rect rect2);
+
+        static uint8_t sBuffer[WIDTH * HEIGHT / 8];
+
+    protected:
+        uint8_t _current_buttons = 0;
+        uint8_t _previous_buttons = 0;
+};
+
+class Arduboy2 : public Arduboy2Base, public Print {
+    public:
+        size_t write(uint8_t c) override;
+
+        void setCursor(int16_t x, int16_t y);
+        void setCursorX(int16_t x) { _cursor_x = x; }
+        void setCursorY(int16_t y) { _cursor_y = y; }
+        void setTextSize(uint8_t s) { _text_size = s < 1 ? 1 : s; }
+
+    private:
+        void drawChar(int16_t x, int16_t y, unsigned char c, uint8_t size);
+
+        int16_t _cursor_x = 0;
+        int16_t _cursor_y = 0;
+        uint8_t _text_size = 1;
+};
+
+class Sprites {
+    public:
+        static void drawOverwrite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+        static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
+};
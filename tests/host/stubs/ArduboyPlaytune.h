@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+// silent. scores and tones end as soon as they start. starting or stopping one costs an op
+class ArduboyPlaytune {
+    public:
+        ArduboyPlaytune(bool (*outEn)()) { (void)outEn; }
+        void initChannel(byte pin) { (void)pin; }
+        void playScore(const byte *score) { (void)score; host_ops++; }
+        void stopScore() { host_ops++; }
+        bool playing() { return false; }
+        void tone(unsigned int frequency, unsigned long duration)
+        {
+            (void)frequency;
+            (void)duration;
+            host_ops++;
+        }
+};
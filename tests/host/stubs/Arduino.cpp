@@ -0,0 +1,188 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+uint32_t host_ops = 0;
+unsigned long host_millis = 0;
+void (*host_wait)(uint16_t ms, bool powered_down) = nullptr;
+USBDevice_ USBDevice;
+FILE *host_serial = nullptr;
+Serial_ Serial;
+uint8_t MCUSR = 0;
+uint8_t WDTCSR = 0;
+static uint8_t sleep_mode_set = SLEEP_MODE_IDLE;
+static uint32_t random_state = 1;
+
+unsigned long millis()
+{
+    return host_millis;
+}
+
+unsigned long micros()
+{
+    return host_millis * 1000;
+}
+
+// avr-libc's random(), a Park-Miller generator with 31 bit results
+static long nextRandom()
+{
+    host_ops++;
+    int32_t x = random_state;
+    if (x == 0)
+        x = 123459876L;
+
+    int32_t hi = x / 127773L;
+    int32_t lo = x % 127773L;
+    x = 16807L * lo - 2836L * hi;
+    if (x < 0)
+        x += 0x7FFFFFFFL;
+
+    random_state = x;
+    return x;
+}
+
+long random(long howbig)
+{
+    if (howbig == 0)
+        return 0;
+
+    return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+        return howsmall;
+
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0)
+        random_state = seed;
+}
+
+size_t Serial_::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t Serial_::write(const uint8_t *buffer, size_t size)
+{
+    if (host_serial != nullptr)
+        fwrite(buffer, 1, size, host_serial);
+
+    return size;
+}
+
+size_t Print::print(const __FlashStringHelper *s)
+{
+    return print(reinterpret_cast<const char *>(s));
+}
+
+size_t Print::print(const char *s)
+{
+    size_t n = 0;
+    while (*s)
+        n += write(*s++);
+
+    return n;
+}
+
+size_t Print::print(char c)
+{
+    return write(c);
+}
+
+size_t Print::print(int n)
+{
+    return print((long)n);
+}
+
+size_t Print::print(unsigned int n)
+{
+    return print((unsigned long)n);
+}
+
+size_t Print::print(long n)
+{
+    if (n >= 0)
+        return print((unsigned long)n);
+
+    return write('-') + print((unsigned long)-n);
+}
+
+size_t Print::print(unsigned long n)
+{
+    char digits[11];
+    uint8_t count = 0;
+    do
+    {
+        digits[count++] = '0' + n % 10;
+        n /= 10;
+    } while (n > 0);
+
+    size_t written = 0;
+    while (count > 0)
+        written += write(digits[--count]);
+
+    return written;
+}
+
+size_t Print::println()
+{
+    return write('\r') + write('\n');
+}
+
+size_t Print::println(const __FlashStringHelper *s)
+{
+    return print(s) + println();
+}
+
+size_t Print::println(const char *s)
+{
+    return print(s) + println();
+}
+
+size_t Print::println(int n)
+{
+    return print(n) + println();
+}
+
+size_t Print::println(unsigned int n)
+{
+    return print(n) + println();
+}
+
+size_t Print::println(long n)
+{
+    return print(n) + println();
+}
+
+size_t Print::println(unsigned long n)
+{
+    return print(n) + println();
+}
+
+void set_sleep_mode(uint8_t mode)
+{
+    sleep_mode_set = mode;
+}
+
+// timer 0 stops while powered down, so millis() doesn't move. nothing but the script
+// can press a button, so sleeping without one would never end
+void sleep_mode()
+{
+    if (sleep_mode_set != SLEEP_MODE_PWR_DOWN)
+        return;
+
+    if (host_wait == nullptr)
+    {
+        fprintf(stderr, "powered down with no script to wake it\n");
+        abort();
+    }
+
+    host_wait(16, true);
+}
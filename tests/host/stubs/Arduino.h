@@ -0,0 +1,86 @@
+#pragma once
+
+// just enough of the Arduino core to build the game modules on a pc
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+
+#define F_CPU 16000000UL
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// a rough stand-in for cpu time, counted by the stubs and the game's COUNT_WORK(). see Arduboy2.h
+extern uint32_t host_ops;
+
+// the clock only moves when the harness says a frame has passed
+extern unsigned long host_millis;
+
+unsigned long millis();
+unsigned long micros();
+
+// called while the game waits for something only time or the buttons can bring: powered
+// down, or in waitNoButtons(). the harness moves its script on by that much time, which
+// can change the buttons. it's nullptr when nothing is running a script
+extern void (*host_wait)(uint16_t ms, bool powered_down);
+
+// same generator as avr-libc, so a fixed seed picks the same numbers as on the Arduboy.
+// each number costs an op
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+
+        size_t print(const __FlashStringHelper *s);
+        size_t print(const char *s);
+        size_t print(char c);
+        size_t print(int n);
+        size_t print(unsigned int n);
+        size_t print(long n);
+        size_t print(unsigned long n);
+        size_t println();
+        size_t println(const __FlashStringHelper *s);
+        size_t println(const char *s);
+        size_t println(int n);
+        size_t println(unsigned int n);
+        size_t println(long n);
+        size_t println(unsigned long n);
+};
+
+// USB can't be unplugged from a pc
+class USBDevice_ {
+    public:
+        void attach() {}
+        void detach() {}
+};
+
+extern USBDevice_ USBDevice;
+
+// what the game writes to Serial goes to this file, or nowhere when it's nullptr
+extern FILE *host_serial;
+
+// USB CDC as if the pc read every packet as soon as it was sent, so a whole
+// 64 byte packet is always free
+class Serial_ : public Print {
+    public:
+        void begin(unsigned long) {}
+        int availableForWrite() { return 64; }
+        size_t write(uint8_t c);
+        size_t write(const uint8_t *buffer, size_t size);
+};
+
+extern Serial_ Serial;
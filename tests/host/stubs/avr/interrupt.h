@@ -0,0 +1,9 @@
+#pragma once
+
+// nothing interrupts the pc. ISR() just defines a function no one calls
+
+#define ISR(vector) void vector()
+#define WDT_vect host_watchdog_interrupt
+
+inline void cli() {}
+inline void sei() {}
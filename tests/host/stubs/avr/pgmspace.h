@@ -0,0 +1,14 @@
+#pragma once
+
+// flash and RAM are the same memory on a pc. every read from flash costs an op
+
+#include <stdint.h>
+#include <string.h>
+
+extern uint32_t host_ops;
+
+#define PROGMEM
+#define pgm_read_byte(p) (host_ops++, *(const uint8_t *)(p))
+#define pgm_read_word(p) (host_ops++, *(const uint16_t *)(p))
+#define pgm_read_ptr(p) (host_ops++, *(void *const *)(p))
+#define memcpy_P memcpy
@@ -0,0 +1,12 @@
+#pragma once
+
+// idle is the same as not sleeping. power down lets host_wait() move the script on
+// by the 16 ms the watchdog would wake the cpu after, see Arduino.h
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+void set_sleep_mode(uint8_t mode);
+void sleep_mode();
@@ -0,0 +1,22 @@
+#pragma once
+
+// the watchdog's registers are plain bytes nothing reads. its wake ups come from sleep_mode()
+
+#include <stdint.h>
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#define WDTO_15MS 0
+
+#define WDRF 3
+#define WDE 3
+#define WDCE 4
+#define WDIE 6
+
+extern uint8_t MCUSR;
+extern uint8_t WDTCSR;
+
+inline void wdt_reset() {}
+inline void wdt_disable() {}
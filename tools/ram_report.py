@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Summarize static RAM use of a GoFetch build.
+
+Lists every .data and .bss symbol by size, the section totals, and how much of
+the ATmega32U4's 2.5 KB is left for the stack.
+
+usage: ram_report.py path/to/GoFetch.ino.elf [--nm avr-nm]
+
+The ELF is written by `arduino-cli compile --output-dir build`, or found in the
+Arduino IDE's temporary build folder.
+"""
+
+import argparse
+import subprocess
+import sys
+
+RAM_SIZE = 2560
+
+
+def read_symbols(nm, elf):
+    """Yields (name, section, size) for every RAM symbol with a size."""
+    out = subprocess.run([nm, "--size-sort", "-S", "-C", elf],
+                         check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) != 4:
+            continue
+        _, size, kind, name = parts
+        kind = kind.lower()
+        if kind == "d":
+            yield name, ".data", int(size, 16)
+        elif kind == "b":
+            yield name, ".bss", int(size, 16)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--nm", default="avr-nm")
+    args = parser.parse_args()
+
+    symbols = sorted(read_symbols(args.nm, args.elf), key=lambda s: -s[2])
+    totals = {".data": 0, ".bss": 0}
+
+    print(f"{'size':>6}  {'section':<7} symbol")
+    for name, section, size in symbols:
+        totals[section] += size
+        print(f"{size:>6}  {section:<7} {name}")
+
+    used = totals[".data"] + totals[".bss"]
+    print()
+    print(f".data    {totals['.data']:>6}")
+    print(f".bss     {totals['.bss']:>6}")
+    print(f"static   {used:>6} of {RAM_SIZE}")
+    print(f"stack    {RAM_SIZE - used:>6} left for the stack")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
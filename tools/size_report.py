@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Break the flash use of a GoFetch build down by asset and subsystem.
+
+Every symbol that takes flash is put into a category:
+  asset:<header>   data defined in assets/<header>.h (sprites, sounds)
+  strings          F() strings
+  game:<module>    code and tables from the sketch's own .cpp/.ino files
+  Arduboy2, ArduboyPlaytune, core   libraries and the Arduino core
+  other            anything else with a symbol (libc, libgcc, vectors)
+  unattributed     flash not covered by any sized symbol (padding, startup code)
+
+The result is compared to a budget file and each category is printed with
+its difference. The exit code is 1 when a category or the total is over
+budget.
+
+usage: size_report.py path/to/GoFetch.ino.elf [--budget tools/size_budget.txt]
+                      [--update-budget] [--nm avr-nm] [--size avr-size]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+FLASH_SIZE = 28672
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+ASSETS_DIR = os.path.join(os.path.dirname(TOOLS_DIR), "assets")
+DEFAULT_BUDGET = os.path.join(TOOLS_DIR, "size_budget.txt")
+
+
+def run(cmd):
+    return subprocess.run(cmd, check=True, capture_output=True, text=True).stdout
+
+
+def asset_names():
+    """Maps every PROGMEM object declared in assets/*.h to its header, so assets are
+    found even when the ELF has no line info for them."""
+    names = {}
+    for header in os.listdir(ASSETS_DIR):
+        if not header.endswith(".h"):
+            continue
+        with open(os.path.join(ASSETS_DIR, header)) as f:
+            for match in re.finditer(r"(\w+)(?:\[\])?\s*(?:PROGMEM\s*)?=?\s*\{", f.read()):
+                names[match.group(1)] = "asset:" + os.path.splitext(header)[0]
+    return names
+
+
+def categorize(name, path, assets):
+    if name.startswith("__c.") or name.startswith("__c_"):
+        return "strings"
+    if name in assets:
+        return assets[name]
+
+    path = path.replace("\\", "/")
+    base = os.path.splitext(os.path.basename(path))[0]
+    if "/assets/" in path:
+        return "asset:" + base
+    if "ArduboyPlaytune" in path:
+        return "ArduboyPlaytune"
+    if "Arduboy2" in path:
+        return "Arduboy2"
+    if "/cores/" in path:
+        return "core"
+    if base and (path.endswith(".cpp") or path.endswith(".ino") or path.endswith(".h")):
+        return "game:" + base.replace(".ino", "")
+    return "other"
+
+
+def flash_symbols(nm, elf):
+    """Yields (name, size, file) for every symbol that takes flash."""
+    for line in run([nm, "-S", "-l", "-C", "--size-sort", elf]).splitlines():
+        symbol, _, location = line.partition("\t")
+        parts = symbol.split(None, 3)
+        if len(parts) != 4:
+            continue
+        _, size, kind, name = parts
+        # text (code + PROGMEM) and the initial values of .data both live in flash
+        if kind.lower() not in ("t", "d", "r"):
+            continue
+        path = location.rsplit(":", 1)[0] if location else ""
+        yield name, int(size, 16), path
+
+
+def flash_total(size_tool, elf):
+    total = 0
+    for line in run([size_tool, "-A", elf]).splitlines():
+        match = re.match(r"^\.(text|data)\s+(\d+)", line)
+        if match:
+            total += int(match.group(2))
+    return total
+
+
+def read_budget(path):
+    budget = {}
+    if not os.path.exists(path):
+        return budget
+    with open(path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if line:
+                category, size = line.split()
+                budget[category] = int(size)
+    return budget
+
+
+def write_budget(path, sizes, limit):
+    with open(path, "w") as f:
+        f.write("# flash budget in bytes per category, see tools/size_report.py\n")
+        f.write("# 'total' is the space left by the 4 KB Caterina bootloader\n")
+        f.write(f"total {limit}\n")
+        for category in sorted(sizes):
+            f.write(f"{category} {sizes[category]}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--budget", default=DEFAULT_BUDGET)
+    parser.add_argument("--update-budget", action="store_true",
+                        help="write the measured sizes as the new budget")
+    parser.add_argument("--nm", default="avr-nm")
+    parser.add_argument("--size", default="avr-size")
+    args = parser.parse_args()
+
+    assets = asset_names()
+    sizes = {}
+    for name, size, path in flash_symbols(args.nm, args.elf):
+        category = categorize(name, path, assets)
+        sizes[category] = sizes.get(category, 0) + size
+
+    total = flash_total(args.size, args.elf)
+    sizes["unattributed"] = max(total - sum(sizes.values()), 0)
+
+    budget = read_budget(args.budget)
+    limit = budget.get("total", FLASH_SIZE)
+
+    if args.update_budget:
+        write_budget(args.budget, sizes, limit)
+        print(f"wrote {args.budget}")
+        return 0
+
+    over = False
+
+    print(f"{'category':<24} {'size':>7} {'budget':>7} {'diff':>7}")
+    for category in sorted(set(sizes) | set(budget) - {"total"}):
+        size = sizes.get(category, 0)
+        if category in budget:
+            diff = size - budget[category]
+            flag = "  OVER" if diff > 0 else ""
+            over |= diff > 0
+            print(f"{category:<24} {size:>7} {budget[category]:>7} {diff:>+7}{flag}")
+        else:
+            print(f"{category:<24} {size:>7} {'-':>7} {'':>7}  no budget")
+
+    flag = "  OVER" if total > limit else ""
+    over |= total > limit
+    print(f"{'total':<24} {total:>7} {limit:>7} {total - limit:>+7}{flag}")
+
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
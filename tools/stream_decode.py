@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Decode the binary stream TELEMETRY_ENABLED and FRAME_STREAM_ENABLED builds send over USB serial.
+
+Every record is [0xA5][type][length][payload], little endian (see SerialLink.h).
+
+Telemetry frame records are either a key frame with absolute values or a
+delta against the previous frame that was sent. Times are sent in 4 us steps
+and written out in us.
+
+The frame stream sends changed screen pages, PackBits compressed, and a
+frame end record after each frame. Each frame end becomes one PBM image.
+
+usage: stream_decode.py telemetry CAPTURE [-o out.csv]
+       stream_decode.py frames CAPTURE [-o frames_dir] [--complete-only]
+
+CAPTURE is a file or a serial device. To read the Arduboy directly on Linux:
+  stty -F /dev/ttyACM0 raw && stream_decode.py telemetry /dev/ttyACM0
+or record first with `cat /dev/ttyACM0 > capture.bin`.
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+SYNC = 0xA5
+MAX_RECORD = 64
+KEY, DELTA, DEATH, PAGE, FRAME_END = 1, 2, 3, 4, 5
+# shortest and longest payload of each record type
+LENGTHS = {KEY: (13, 13), DELTA: (8, 8), DEATH: (2, 2),
+           PAGE: (4, MAX_RECORD - 3), FRAME_END: (2, 2)}
+FRAME_COMPLETE = 0x01
+WIDTH, HEIGHT = 128, 64
+FIELDS = ["update_us", "draw_us", "squirrels", "balls", "spawns", "barks", "score"]
+TIME_STEP_US = 4
+
+
+def records(stream):
+    """Yields (type, payload) for every well formed record. Bytes that don't
+    start a known record are skipped, so a capture can start mid record."""
+    buffer = b""
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            return
+        buffer += chunk
+
+        i = 0
+        while len(buffer) - i >= 3:
+            if buffer[i] != SYNC:
+                i += 1
+                continue
+            kind, length = buffer[i + 1], buffer[i + 2]
+            shortest, longest = LENGTHS.get(kind, (1, 0))
+            if not shortest <= length <= longest:
+                i += 1
+                continue
+            if len(buffer) - i < 3 + length:
+                break
+            yield kind, buffer[i + 3:i + 3 + length]
+            i += 3 + length
+        buffer = buffer[i:]
+
+
+def decode_telemetry(stream, out):
+    writer = csv.writer(out)
+    writer.writerow(["seq", "event"] + FIELDS)
+
+    last = None
+    dropped = 0
+    prev_seq = None
+    for kind, payload in records(stream):
+        if kind not in (KEY, DELTA, DEATH):
+            continue
+        if kind == DEATH:
+            (score,) = struct.unpack("<H", payload)
+            writer.writerow(["", "death"] + [""] * (len(FIELDS) - 1) + [score])
+            continue
+
+        seq = payload[0]
+        if kind == KEY:
+            values = list(struct.unpack("<HHBBHHH", payload[1:]))
+        elif last is None:
+            continue  # a delta needs a key frame first
+        else:
+            deltas = struct.unpack("<7b", payload[1:])
+            values = [v + d for v, d in zip(last, deltas)]
+        last = values
+
+        if prev_seq is not None:
+            dropped += (seq - prev_seq - 1) % 256
+        prev_seq = seq
+
+        row = [values[0] * TIME_STEP_US, values[1] * TIME_STEP_US] + values[2:]
+        writer.writerow([seq, "key" if kind == KEY else "frame"] + row)
+
+    if dropped:
+        print(f"{dropped} frames were dropped by the byte budget", file=sys.stderr)
+
+
+def unpack_bits(data, out):
+    """Appends the bytes of a PackBits run to out. A control byte below 128 is
+    followed by control + 1 literal bytes, from 128 up the next byte repeats
+    control - 126 times."""
+    i = 0
+    while i < len(data):
+        control = data[i]
+        if control < 128:
+            out += data[i + 1:i + 2 + control]
+            i += 2 + control
+        else:
+            out += bytes([data[i + 1]]) * (control - 126)
+            i += 2
+
+
+def write_pbm(path, screen):
+    """Screen bytes are 8 pixel high pages, one byte per column, low bit on top."""
+    rows = bytearray()
+    for y in range(HEIGHT):
+        page = (y // 8) * WIDTH
+        for x in range(0, WIDTH, 8):
+            bits = 0
+            for column in range(x, x + 8):
+                lit = screen[page + column] >> (y % 8) & 1
+                bits = bits << 1 | (not lit)  # PBM 1 is black, the OLED lights 1s
+            rows.append(bits)
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (WIDTH, HEIGHT))
+        f.write(rows)
+
+
+def decode_frames(stream, directory, complete_only):
+    os.makedirs(directory, exist_ok=True)
+    screen = bytearray(WIDTH * HEIGHT // 8)
+    written = 0
+    partial = 0
+    for kind, payload in records(stream):
+        if kind == PAGE:
+            page, column = payload[0], payload[1]
+            data = bytearray()
+            unpack_bits(payload[2:], data)
+            start = page * WIDTH + column
+            end = min(start + len(data), (page + 1) * WIDTH)
+            screen[start:end] = data[:end - start]
+        elif kind == FRAME_END:
+            if not payload[1] & FRAME_COMPLETE:
+                partial += 1
+                if complete_only:
+                    continue
+            write_pbm(os.path.join(directory, f"frame_{written:05d}.pbm"), screen)
+            written += 1
+
+    print(f"wrote {written} frames to {directory}, {partial} still catching up "
+          "with the screen", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    telemetry = commands.add_parser("telemetry", help="write frame and death records as CSV")
+    telemetry.add_argument("capture")
+    telemetry.add_argument("-o", "--output", help="CSV file, stdout by default")
+
+    frames = commands.add_parser("frames", help="write each streamed frame as a PBM image")
+    frames.add_argument("capture")
+    frames.add_argument("-o", "--output", default="frames", help="directory for the images")
+    frames.add_argument("--complete-only", action="store_true",
+                        help="skip frames where some pages hadn't been sent yet")
+
+    args = parser.parse_args()
+
+    with open(args.capture, "rb", buffering=0) as stream:
+        if args.command == "frames":
+            decode_frames(stream, args.output, args.complete_only)
+        elif args.output:
+            with open(args.output, "w", newline="") as out:
+                decode_telemetry(stream, out)
+        else:
+            decode_telemetry(stream, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())